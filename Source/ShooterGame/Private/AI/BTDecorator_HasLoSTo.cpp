@@ -2,6 +2,7 @@
 
 #include "AI/BTDecorator_HasLoSTo.h"
 #include "AI/ShooterAIController.h"
+#include "AI/ShooterAIPerception.h"
 #include "Player/ShooterCharacter.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
@@ -106,6 +107,14 @@ bool UBTDecorator_HasLoSTo::LOSTrace(AActor* InActor, AActor* InEnemyActor, cons
 	AShooterCharacter* MyBot = MyController ? Cast<AShooterCharacter>(MyController->GetPawn()) : NULL; 
 
 	bool bHasLOS = false;
+
+	//enemy characters are traced by the shared perception cache
+	UShooterAIPerception* Perception = UShooterAIPerception::Get(GetWorld());
+	if (Perception && Cast<AShooterCharacter>(InEnemyActor) && Perception->GetLineOfSight(MyController, InEnemyActor, bHasLOS))
+	{
+		return bHasLOS;
+	}
+
 	{
 		if (MyBot != NULL)
 		{
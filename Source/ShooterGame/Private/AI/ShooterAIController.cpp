@@ -4,9 +4,12 @@
 #include "AI/ShooterAIController.h"
 #include "Weapons/ShooterWeapon.h"
 #include "GameRules/ShooterGameMode.h"
+#include "GameRules/ShooterGameState.h"
 #include "GameFramework/GameStateBase.h"
 #include "Player/ShooterPlayerState.h"
 #include "Player/ShooterCharacter.h"
+#include "Player/ShooterCharacterSpatialIndex.h"
+#include "AI/ShooterAIPerception.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "BehaviorTree/BehaviorTreeComponent.h"
 #include "BehaviorTree/BehaviorTree.h"
@@ -73,22 +76,14 @@ void AShooterAIController::FindClosestEnemy()
 		return;
 	}
 
-	const FVector MyLoc = MyBot->GetActorLocation();
-	float BestDistSq = MAX_FLT;
+	UShooterCharacterSpatialIndex* SpatialIndex = GetWorld()->GetSubsystem<UShooterCharacterSpatialIndex>();
 	AShooterCharacter* BestPawn = NULL;
-
-	for (TActorIterator<AShooterCharacter> It(GetWorld()); It; ++It)
+	if (SpatialIndex)
 	{
-		AShooterCharacter* TestPawn = *It;
-		if (TestPawn && TestPawn->IsAlive() && IsEnemyFor(TestPawn->Controller))
+		BestPawn = SpatialIndex->FindClosestCharacter(MyBot->GetActorLocation(), [this](AShooterCharacter* TestPawn)
 		{
-			const float DistSq = (TestPawn->GetActorLocation() - MyLoc).SizeSquared();
-			if (DistSq < BestDistSq)
-			{
-				BestDistSq = DistSq;
-				BestPawn = TestPawn;
-			}
-		}
+			return IsEnemyFor(TestPawn->Controller);
+		});
 	}
 
 	if (BestPawn)
@@ -102,28 +97,28 @@ bool AShooterAIController::FindClosestEnemyWithLOS(AShooterCharacter* ExcludeEne
 {
 	bool bGotEnemy = false;
 	APawn* MyBot = GetPawn();
-	if (MyBot != NULL)
-	{
-		const FVector MyLoc = MyBot->GetActorLocation();
-		float BestDistSq = MAX_FLT;
-		AShooterCharacter* BestPawn = NULL;
 
-		for (TActorIterator<AShooterCharacter> It(GetWorld()); It; ++It)
+	//use the shared LOS cache once it has traced our enemies
+	UShooterAIPerception* Perception = UShooterAIPerception::Get(GetWorld());
+	AShooterCharacter* PerceivedEnemy = NULL;
+	if (Perception && Perception->FindClosestVisibleEnemy(this, ExcludeEnemy, PerceivedEnemy))
+	{
+		if (PerceivedEnemy)
 		{
-			AShooterCharacter* TestPawn = *It;
-			if (TestPawn && TestPawn != ExcludeEnemy && TestPawn->IsAlive() && IsEnemyFor(TestPawn->Controller))
-			{
-				if (HasWeaponLOSToEnemy(TestPawn, true) == true)
-				{
-					const float DistSq = (TestPawn->GetActorLocation() - MyLoc).SizeSquared();
-					if (DistSq < BestDistSq)
-					{
-						BestDistSq = DistSq;
-						BestPawn = TestPawn;
-					}
-				}
-			}
+			SetEnemy(PerceivedEnemy);
+			bGotEnemy = true;
 		}
+		return bGotEnemy;
+	}
+
+	UShooterCharacterSpatialIndex* SpatialIndex = GetWorld()->GetSubsystem<UShooterCharacterSpatialIndex>();
+	if (MyBot != NULL && SpatialIndex != NULL)
+	{
+		//candidates come closest first, so LOS is only traced until the first visible enemy
+		AShooterCharacter* BestPawn = SpatialIndex->FindClosestCharacter(MyBot->GetActorLocation(), [this, ExcludeEnemy](AShooterCharacter* TestPawn)
+		{
+			return TestPawn != ExcludeEnemy && IsEnemyFor(TestPawn->Controller) && HasWeaponLOSToEnemy(TestPawn, true);
+		});
 		if (BestPawn)
 		{
 			SetEnemy(BestPawn);
@@ -201,10 +196,13 @@ void AShooterAIController::ShootEnemy()
 	AShooterCharacter* Enemy = GetEnemy();
 	if (Enemy && Enemy->IsAlive() && CurrentWeapon->HasEnoughAmmo() && CurrentWeapon->CanFire() == true )
 	{
-		if (LineOfSightTo(Enemy, MyBot->GetActorLocation()))
+		UShooterAIPerception* Perception = UShooterAIPerception::Get(GetWorld());
+		bool bHasLOS = false;
+		if (Perception == NULL || !Perception->GetLineOfSight(this, Enemy, bHasLOS))
 		{
-			bCanShoot = true;
+			bHasLOS = LineOfSightTo(Enemy, MyBot->GetActorLocation());
 		}
+		bCanShoot = bHasLOS;
 	}
 
 	if (bCanShoot && Enemy->GetMesh())
@@ -336,16 +334,6 @@ bool AShooterAIController::IsEnemyFor(AController* TestPC) const
 		return false;
 	}
 
-	AShooterPlayerState* TestPlayerState = TestPC->GetPlayerState<AShooterPlayerState>();
-	AShooterPlayerState* MyPlayerState = GetPlayerState<AShooterPlayerState>();
-
-	if (TestPC->GetWorld()->GetGameState() && GetWorld()->GetGameState()->GameModeClass)
-	{
-		const AShooterGameMode* DefGame = GetWorld()->GetGameState()->GameModeClass->GetDefaultObject<AShooterGameMode>();
-		if (DefGame && MyPlayerState && TestPlayerState)
-		{
-			return DefGame->CanDealDamage(TestPlayerState, MyPlayerState);
-		}
-	}
-	return true;
+	AShooterGameState* MyGameState = GetWorld()->GetGameState<AShooterGameState>();
+	return MyGameState == NULL || MyGameState->AreEnemies(TestPC->GetPlayerState<AShooterPlayerState>(), GetPlayerState<AShooterPlayerState>());
 }
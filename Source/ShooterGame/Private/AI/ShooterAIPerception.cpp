@@ -0,0 +1,180 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#include "AI/ShooterAIPerception.h"
+#include "AI/ShooterAIController.h"
+#include "Player/ShooterCharacter.h"
+#include "Player/ShooterCharacterSpatialIndex.h"
+
+UShooterAIPerception::UShooterAIPerception()
+{
+	RefreshInterval = 0.25f;
+	TracesPerTick = 32;
+	PerceptionRadius = 20000.f;
+	NextPerceiver = 0;
+}
+
+UShooterAIPerception* UShooterAIPerception::Get(UWorld* World)
+{
+	if (World == NULL || !World->IsGameWorld() || World->GetNetMode() == NM_Client)
+	{
+		return NULL;
+	}
+	return World->GetSubsystem<UShooterAIPerception>();
+}
+
+bool UShooterAIPerception::IsTickable() const
+{
+	return Perceivers.Num() > 0;
+}
+
+TStatId UShooterAIPerception::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterAIPerception, STATGROUP_Tickables);
+}
+
+UWorld* UShooterAIPerception::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+FShooterPerceiver& UShooterAIPerception::FindOrAddPerceiver(AShooterAIController* Controller)
+{
+	for (FShooterPerceiver& Perceiver : Perceivers)
+	{
+		if (Perceiver.Controller.Get() == Controller)
+		{
+			return Perceiver;
+		}
+	}
+	FShooterPerceiver& Perceiver = Perceivers[Perceivers.AddDefaulted()];
+	Perceiver.Controller = Controller;
+	return Perceiver;
+}
+
+void UShooterAIPerception::RebuildEnemies(FShooterPerceiver& Perceiver)
+{
+	AShooterAIController* Controller = Perceiver.Controller.Get();
+	UShooterCharacterSpatialIndex* SpatialIndex = GetWorld()->GetSubsystem<UShooterCharacterSpatialIndex>();
+
+	TArray<AShooterCharacter*> Nearby;
+	SpatialIndex->GetCharactersInRadius(Controller->GetPawn()->GetActorLocation(), PerceptionRadius, Nearby);
+
+	TArray<FShooterPerceivedEnemy> NewEnemies;
+	NewEnemies.Reserve(Nearby.Num());
+	for (AShooterCharacter* TestPawn : Nearby)
+	{
+		if (!Controller->IsEnemyFor(TestPawn->Controller))
+		{
+			continue;
+		}
+		FShooterPerceivedEnemy& Entry = NewEnemies[NewEnemies.AddDefaulted()];
+		Entry.Enemy = TestPawn;
+		for (const FShooterPerceivedEnemy& Known : Perceiver.Enemies)
+		{
+			if (Known.Enemy.Get() == TestPawn)
+			{
+				Entry = Known;
+				break;
+			}
+		}
+	}
+	Perceiver.Enemies = MoveTemp(NewEnemies);
+}
+
+void UShooterAIPerception::Tick(float DeltaTime)
+{
+	if (GetWorld()->GetSubsystem<UShooterCharacterSpatialIndex>() == NULL)
+	{
+		return;
+	}
+	const float Now = GetWorld()->GetTimeSeconds();
+	int32 TracesLeft = TracesPerTick;
+	for (int32 NumVisited = 0; NumVisited < Perceivers.Num() && TracesLeft > 0; NumVisited++)
+	{
+		NextPerceiver = (NextPerceiver < Perceivers.Num()) ? NextPerceiver : 0;
+		FShooterPerceiver& Perceiver = Perceivers[NextPerceiver];
+		AShooterAIController* Controller = Perceiver.Controller.Get();
+		if (Controller == NULL || Controller->GetPawn() == NULL)
+		{
+			//bots without a pawn ask again when they have one
+			Perceivers.RemoveAtSwap(NextPerceiver);
+			continue;
+		}
+
+		if (Perceiver.NextEnemy == 0)
+		{
+			if (Now - Perceiver.RefreshTime < RefreshInterval)
+			{
+				NextPerceiver++;
+				continue;
+			}
+			Perceiver.RefreshTime = Now;
+			RebuildEnemies(Perceiver);
+		}
+
+		while (Perceiver.NextEnemy < Perceiver.Enemies.Num() && TracesLeft > 0)
+		{
+			FShooterPerceivedEnemy& Entry = Perceiver.Enemies[Perceiver.NextEnemy++];
+			AShooterCharacter* Enemy = Entry.Enemy.Get();
+			Entry.bVisible = Enemy && Enemy->IsAlive() && Controller->HasWeaponLOSToEnemy(Enemy, true);
+			Entry.bTraced = true;
+			TracesLeft--;
+		}
+		if (Perceiver.NextEnemy < Perceiver.Enemies.Num())
+		{
+			//out of traces; continue this row next tick
+			break;
+		}
+		Perceiver.NextEnemy = 0;
+		Perceiver.bHasResults = true;
+		NextPerceiver++;
+	}
+}
+
+bool UShooterAIPerception::FindClosestVisibleEnemy(AShooterAIController* Controller, AShooterCharacter* ExcludeEnemy, AShooterCharacter*& OutEnemy)
+{
+	OutEnemy = NULL;
+	APawn* MyBot = Controller ? Controller->GetPawn() : NULL;
+	if (MyBot == NULL)
+	{
+		return false;
+	}
+	FShooterPerceiver& Perceiver = FindOrAddPerceiver(Controller);
+	if (!Perceiver.bHasResults)
+	{
+		return false;
+	}
+
+	float BestDistSq = MAX_FLT;
+	for (const FShooterPerceivedEnemy& Entry : Perceiver.Enemies)
+	{
+		AShooterCharacter* Enemy = Entry.Enemy.Get();
+		if (Entry.bVisible && Enemy && Enemy != ExcludeEnemy && Enemy->IsAlive())
+		{
+			const float DistSq = FVector::DistSquared(Enemy->GetActorLocation(), MyBot->GetActorLocation());
+			if (DistSq < BestDistSq)
+			{
+				BestDistSq = DistSq;
+				OutEnemy = Enemy;
+			}
+		}
+	}
+	return true;
+}
+
+bool UShooterAIPerception::GetLineOfSight(AShooterAIController* Controller, const AActor* Enemy, bool& bOutVisible)
+{
+	if (Controller == NULL || Controller->GetPawn() == NULL || Enemy == NULL)
+	{
+		return false;
+	}
+	for (const FShooterPerceivedEnemy& Entry : FindOrAddPerceiver(Controller).Enemies)
+	{
+		if (Entry.bTraced && Entry.Enemy.Get() == Enemy)
+		{
+			bOutVisible = Entry.bVisible;
+			return true;
+		}
+	}
+	return false;
+}
@@ -1,6 +1,8 @@
 // Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved. 
 
 #include "AI/ShooterMonsterController.h"
+#include "AI/ShooterMonsterPool.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
 
 
 AShooterMonsterController::AShooterMonsterController()
@@ -8,6 +10,24 @@ AShooterMonsterController::AShooterMonsterController()
 	bWantsPlayerState = false;
 }
 
+void AShooterMonsterController::PawnPendingDestroy(APawn* InPawn)
+{
+	UShooterMonsterPool* MonsterPool = GetWorld()->GetSubsystem<UShooterMonsterPool>();
+	if (InPawn == GetPawn() && MonsterPool && MonsterPool->ReleaseController(this))
+	{
+		return;
+	}
+	Super::PawnPendingDestroy(InPawn);
+}
+
+void AShooterMonsterController::DeactivateForPool()
+{
+	GetBehaviorComp()->StopTree();
+	StopMovement();
+	SetEnemy(NULL);
+	UnPossess();
+}
+
 bool AShooterMonsterController::IsEnemyFor(AController* TestPC) const
 {
 	//only human players and bots have PlayerStates, so if TestPC has a player state, then it's not a monster, therefore, enemy.
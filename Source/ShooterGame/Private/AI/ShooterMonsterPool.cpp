@@ -0,0 +1,90 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#include "AI/ShooterMonsterPool.h"
+#include "AI/ShooterMonsterController.h"
+#include "Player/ShooterCharacter.h"
+
+void UShooterMonsterPool::Deinitialize()
+{
+	Pools.Empty();
+	Super::Deinitialize();
+}
+
+AShooterCharacter* UShooterMonsterPool::AcquireMonster(TSubclassOf<AShooterCharacter> MonsterClass, const FVector& Location, const FRotator& Rotation)
+{
+	FShooterMonsterPoolEntry* Entry = MonsterClass ? Pools.Find(MonsterClass) : NULL;
+	if (!Entry)
+	{
+		return NULL;
+	}
+	while (Entry->FreeMonsters.Num() > 0)
+	{
+		AShooterCharacter* Monster = Entry->FreeMonsters.Pop(false);
+		if (Monster && !Monster->IsPendingKill())
+		{
+			Monster->ActivateFromPool(Location, Rotation);
+			return Monster;
+		}
+	}
+	return NULL;
+}
+
+bool UShooterMonsterPool::PossessMonster(AShooterCharacter* Monster)
+{
+	FShooterMonsterPoolEntry* Entry = Monster ? Pools.Find(Monster->GetClass()) : NULL;
+	if (!Entry)
+	{
+		return false;
+	}
+	while (Entry->FreeControllers.Num() > 0)
+	{
+		AShooterMonsterController* Controller = Entry->FreeControllers.Pop(false);
+		if (Controller && !Controller->IsPendingKill())
+		{
+			Controller->Possess(Monster);
+			return true;
+		}
+	}
+	return false;
+}
+
+void UShooterMonsterPool::ReleaseMonster(AShooterCharacter* Monster)
+{
+	if (!Monster || Monster->bInPool)
+	{
+		return;
+	}
+	AShooterMonsterController* Controller = Cast<AShooterMonsterController>(Monster->GetController());
+	if (Controller && !ReleaseController(Controller))
+	{
+		Controller->Destroy();
+	}
+
+	UWorld* World = GetWorld();
+	FShooterMonsterPoolEntry& Entry = Pools.FindOrAdd(Monster->GetClass());
+	if (Entry.FreeMonsters.Num() >= MaxPooledPerClass || !World || World->bIsTearingDown)
+	{
+		Monster->Destroy();
+		return;
+	}
+	Monster->DeactivateForPool();
+	Entry.FreeMonsters.Add(Monster);
+}
+
+bool UShooterMonsterPool::ReleaseController(AShooterMonsterController* Controller)
+{
+	UWorld* World = GetWorld();
+	APawn* Monster = Controller ? Controller->GetPawn() : NULL;
+	if (!Monster || !World || World->bIsTearingDown)
+	{
+		return false;
+	}
+	FShooterMonsterPoolEntry& Entry = Pools.FindOrAdd(Monster->GetClass());
+	if (Entry.FreeControllers.Num() >= MaxPooledPerClass)
+	{
+		return false;
+	}
+	Controller->DeactivateForPool();
+	Entry.FreeControllers.Add(Controller);
+	return true;
+}
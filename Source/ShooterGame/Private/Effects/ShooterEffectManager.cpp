@@ -0,0 +1,334 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#include "Effects/ShooterEffectManager.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Components/DecalComponent.h"
+#include "Components/PointLightComponent.h"
+#include "Materials/Material.h"
+
+UShooterEffectManager::UShooterEffectManager()
+{
+	MaxActiveEmitters = 96;
+	MaxActiveDecals = 64;
+	MaxActiveLights = 8;
+}
+
+UShooterEffectManager* UShooterEffectManager::Get(UWorld* World)
+{
+	if (World == NULL || World->GetNetMode() == NM_DedicatedServer || World->bIsTearingDown)
+	{
+		return NULL;
+	}
+	return World->GetSubsystem<UShooterEffectManager>();
+}
+
+void UShooterEffectManager::Deinitialize()
+{
+	for (auto& PoolPair : EmitterPools)
+	{
+		for (UParticleSystemComponent* PSC : PoolPair.Value.FreeComponents)
+		{
+			if (PSC)
+			{
+				PSC->DestroyComponent();
+			}
+		}
+	}
+	for (UParticleSystemComponent* PSC : ActiveEmitters)
+	{
+		if (PSC)
+		{
+			PSC->DestroyComponent();
+		}
+	}
+	for (const FShooterActiveDecal& ActiveDecal : ActiveDecals)
+	{
+		if (ActiveDecal.Decal)
+		{
+			ActiveDecal.Decal->DestroyComponent();
+		}
+	}
+	for (UDecalComponent* Decal : FreeDecals)
+	{
+		if (Decal)
+		{
+			Decal->DestroyComponent();
+		}
+	}
+	for (const FShooterActiveLight& ActiveLight : ActiveLights)
+	{
+		if (ActiveLight.Light)
+		{
+			ActiveLight.Light->DestroyComponent();
+		}
+	}
+	for (UPointLightComponent* Light : FreeLights)
+	{
+		if (Light)
+		{
+			Light->DestroyComponent();
+		}
+	}
+	EmitterPools.Empty();
+	ActiveEmitters.Empty();
+	ActiveDecals.Empty();
+	FreeDecals.Empty();
+	ActiveLights.Empty();
+	FreeLights.Empty();
+	Super::Deinitialize();
+}
+
+bool UShooterEffectManager::IsTickable() const
+{
+	return !HasAnyFlags(RF_ClassDefaultObject) && (ActiveDecals.Num() > 0 || ActiveLights.Num() > 0);
+}
+
+TStatId UShooterEffectManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterEffectManager, STATGROUP_Tickables);
+}
+
+UWorld* UShooterEffectManager::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+void UShooterEffectManager::Tick(float DeltaTime)
+{
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	// decals are kept in expiry order, so only the front of the list can expire
+	while (ActiveDecals.Num() > 0 && ActiveDecals[0].ExpireTime <= Now)
+	{
+		ReleaseDecal(ActiveDecals[0].Decal);
+	}
+
+	for (int32 i = ActiveLights.Num() - 1; i >= 0; i--)
+	{
+		const FShooterActiveLight& ActiveLight = ActiveLights[i];
+		const float TimeRemaining = FMath::Max(0.0f, ActiveLight.FadeOut - (Now - ActiveLight.StartTime));
+		if (TimeRemaining > 0 && ActiveLight.Light)
+		{
+			const float FadeAlpha = 1.0f - FMath::Square(TimeRemaining / ActiveLight.FadeOut);
+			ActiveLight.Light->SetIntensity(ActiveLight.Intensity * FadeAlpha);
+		}
+		else
+		{
+			ReleaseLight(ActiveLight.Light);
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Emitters
+
+UParticleSystemComponent* UShooterEffectManager::AcquireEmitter(UParticleSystem* Template)
+{
+	if (ActiveEmitters.Num() >= MaxActiveEmitters && ActiveEmitters.Num() > 0)
+	{
+		ReleaseEmitter(ActiveEmitters[0]);
+	}
+
+	UParticleSystemComponent* PSC = NULL;
+	FShooterEmitterPool& Pool = EmitterPools.FindOrAdd(Template);
+	while (PSC == NULL && Pool.FreeComponents.Num() > 0)
+	{
+		PSC = Pool.FreeComponents.Pop(false);
+		if (PSC && PSC->IsPendingKill())
+		{
+			PSC = NULL;
+		}
+	}
+	if (PSC == NULL)
+	{
+		UWorld* World = GetWorld();
+		PSC = NewObject<UParticleSystemComponent>(World);
+		PSC->bAutoDestroy = false;
+		PSC->bAutoActivate = false;
+		PSC->bAllowAnyoneToDestroyMe = true;
+		PSC->SecondsBeforeInactive = 0.0f;
+		PSC->SetTemplate(Template);
+		PSC->OnSystemFinished.AddDynamic(this, &UShooterEffectManager::OnEmitterFinished);
+		PSC->RegisterComponentWithWorld(World);
+	}
+	ActiveEmitters.Add(PSC);
+	return PSC;
+}
+
+UParticleSystemComponent* UShooterEffectManager::SpawnEmitter(UParticleSystem* Template, const FVector& Location, const FRotator& Rotation)
+{
+	if (Template == NULL)
+	{
+		return NULL;
+	}
+	UParticleSystemComponent* PSC = AcquireEmitter(Template);
+	PSC->SetRelativeScale3D(FVector(1.f));
+	PSC->SetWorldLocationAndRotation(Location, Rotation);
+	PSC->ActivateSystem(true);
+	return PSC;
+}
+
+UParticleSystemComponent* UShooterEffectManager::SpawnEmitterAttached(UParticleSystem* Template, USceneComponent* AttachTo, FName AttachPointName)
+{
+	if (Template == NULL || AttachTo == NULL)
+	{
+		return NULL;
+	}
+	UParticleSystemComponent* PSC = AcquireEmitter(Template);
+	PSC->AttachToComponent(AttachTo, FAttachmentTransformRules::KeepRelativeTransform, AttachPointName);
+	PSC->SetRelativeTransform(FTransform::Identity);
+	PSC->ActivateSystem(true);
+	return PSC;
+}
+
+void UShooterEffectManager::ReleaseEmitter(UParticleSystemComponent* PSC)
+{
+	// removed first, since deactivating fires OnSystemFinished again
+	if (PSC == NULL || ActiveEmitters.RemoveSingle(PSC) == 0)
+	{
+		return;
+	}
+	PSC->DeactivateImmediate();
+	PSC->InstanceParameters.Reset();
+	if (PSC->GetAttachParent())
+	{
+		PSC->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+	}
+	FShooterEmitterPool& Pool = EmitterPools.FindOrAdd(PSC->Template);
+	if (Pool.FreeComponents.Num() < MaxPooledPerTemplate && !PSC->IsPendingKill())
+	{
+		Pool.FreeComponents.Add(PSC);
+	}
+	else
+	{
+		PSC->DestroyComponent();
+	}
+}
+
+void UShooterEffectManager::OnEmitterFinished(UParticleSystemComponent* PSC)
+{
+	ReleaseEmitter(PSC);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Decals
+
+UDecalComponent* UShooterEffectManager::SpawnDecal(const FDecalData& Decal, UPrimitiveComponent* AttachTo, FName AttachPointName, const FVector& Location, const FRotator& Rotation)
+{
+	if (Decal.DecalMaterial == NULL || AttachTo == NULL || MaxActiveDecals <= 0)
+	{
+		return NULL;
+	}
+	if (ActiveDecals.Num() >= MaxActiveDecals)
+	{
+		ReleaseDecal(ActiveDecals[0].Decal);
+	}
+
+	UDecalComponent* DecalComp = NULL;
+	while (DecalComp == NULL && FreeDecals.Num() > 0)
+	{
+		DecalComp = FreeDecals.Pop(false);
+		if (DecalComp && DecalComp->IsPendingKill())
+		{
+			DecalComp = NULL;
+		}
+	}
+	if (DecalComp == NULL)
+	{
+		UWorld* World = GetWorld();
+		DecalComp = NewObject<UDecalComponent>(World);
+		DecalComp->bAllowAnyoneToDestroyMe = true;
+		DecalComp->RegisterComponentWithWorld(World);
+	}
+
+	DecalComp->SetDecalMaterial(Decal.DecalMaterial);
+	DecalComp->DecalSize = FVector(Decal.DecalSize, Decal.DecalSize, 1.0f);
+	DecalComp->AttachToComponent(AttachTo, FAttachmentTransformRules::KeepRelativeTransform, AttachPointName);
+	DecalComp->SetWorldLocationAndRotation(Location, Rotation);
+	DecalComp->SetVisibility(true);
+	DecalComp->MarkRenderStateDirty();
+
+	FShooterActiveDecal ActiveDecal;
+	ActiveDecal.Decal = DecalComp;
+	ActiveDecal.ExpireTime = Decal.LifeSpan > 0.f ? GetWorld()->GetTimeSeconds() + Decal.LifeSpan : MAX_FLT;
+	// keep the list in expiry order; with equal lifespans this is always the end
+	int32 InsertIndex = ActiveDecals.Num();
+	while (InsertIndex > 0 && ActiveDecals[InsertIndex - 1].ExpireTime > ActiveDecal.ExpireTime)
+	{
+		InsertIndex--;
+	}
+	ActiveDecals.Insert(ActiveDecal, InsertIndex);
+	return DecalComp;
+}
+
+void UShooterEffectManager::ReleaseDecal(UDecalComponent* Decal)
+{
+	ActiveDecals.RemoveAll([Decal](const FShooterActiveDecal& ActiveDecal) { return ActiveDecal.Decal == Decal; });
+	if (Decal == NULL || Decal->IsPendingKill())
+	{
+		return;
+	}
+	Decal->SetVisibility(false);
+	Decal->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+	FreeDecals.Add(Decal);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Lights
+
+void UShooterEffectManager::SpawnFadingLight(const UPointLightComponent* LightTemplate, const FVector& Location, float FadeOut)
+{
+	if (LightTemplate == NULL || FadeOut <= 0.f || MaxActiveLights <= 0 || !LightTemplate->IsVisible() || LightTemplate->Intensity <= 0.f)
+	{
+		return;
+	}
+	if (ActiveLights.Num() >= MaxActiveLights)
+	{
+		ReleaseLight(ActiveLights[0].Light);
+	}
+
+	UPointLightComponent* Light = NULL;
+	while (Light == NULL && FreeLights.Num() > 0)
+	{
+		Light = FreeLights.Pop(false);
+		if (Light && Light->IsPendingKill())
+		{
+			Light = NULL;
+		}
+	}
+	if (Light == NULL)
+	{
+		UWorld* World = GetWorld();
+		Light = NewObject<UPointLightComponent>(World);
+		Light->bAllowAnyoneToDestroyMe = true;
+		Light->CastShadows = false;
+		Light->RegisterComponentWithWorld(World);
+	}
+
+	Light->SetWorldLocation(Location);
+	Light->SetAttenuationRadius(LightTemplate->AttenuationRadius);
+	Light->SetLightColor(LightTemplate->LightColor);
+	Light->SetCastShadows(LightTemplate->CastShadows);
+	Light->bUseInverseSquaredFalloff = LightTemplate->bUseInverseSquaredFalloff;
+	Light->SetIntensity(0.f);
+	Light->SetVisibility(true);
+
+	FShooterActiveLight ActiveLight;
+	ActiveLight.Light = Light;
+	ActiveLight.StartTime = GetWorld()->GetTimeSeconds();
+	ActiveLight.FadeOut = FadeOut;
+	ActiveLight.Intensity = LightTemplate->Intensity;
+	ActiveLights.Add(ActiveLight);
+}
+
+void UShooterEffectManager::ReleaseLight(UPointLightComponent* Light)
+{
+	ActiveLights.RemoveAll([Light](const FShooterActiveLight& ActiveLight) { return ActiveLight.Light == Light; });
+	if (Light == NULL || Light->IsPendingKill())
+	{
+		return;
+	}
+	Light->SetVisibility(false);
+	FreeLights.Add(Light);
+}
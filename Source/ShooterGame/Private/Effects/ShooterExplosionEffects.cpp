@@ -2,6 +2,7 @@
 // Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
 
 #include "Effects/ShooterExplosionEffect.h"
+#include "Effects/ShooterEffectManager.h"
 #include "Particles/ParticleSystem.h"
 #include "Components/PointLightComponent.h"
 #include "Sound/SoundCue.h"
@@ -31,39 +32,53 @@ void AShooterExplosionEffect::BeginPlay()
 {
 	Super::BeginPlay();
 
-	const FVector EffectLocation = SurfaceHit.ImpactPoint;
+	//this actor fades its own light
+	PlayExplosion(GetWorld(), SurfaceHit, GetActorLocation(), false);
+}
+
+void AShooterExplosionEffect::PlayExplosion(UWorld* World, const FHitResult& Hit, const FVector& LightLocation, bool bWithLight) const
+{
+	UShooterEffectManager* EffectManager = UShooterEffectManager::Get(World);
+	if (EffectManager == NULL)
+	{
+		return;
+	}
+
+	const FVector EffectLocation = Hit.ImpactPoint;
 	if (ExplosionFX)
 	{
 		FRotator ParticleRotation = FRotator::ZeroRotator;
 		if (!ExplosionRotationAlwaysZero)
 		{
-			ParticleRotation = SurfaceHit.ImpactNormal.Rotation();
+			ParticleRotation = Hit.ImpactNormal.Rotation();
 			//change pitch so that the particle is Z-up with the impact normal
 			ParticleRotation.Pitch -= 90.f;
 		}
-		UGameplayStatics::SpawnEmitterAtLocation(this, ExplosionFX, EffectLocation, ParticleRotation);
+		EffectManager->SpawnEmitter(ExplosionFX, EffectLocation, ParticleRotation);
 	}
 
 	if (ExplosionSound)
 	{
-		UGameplayStatics::PlaySoundAtLocation(this, ExplosionSound, EffectLocation);
+		UGameplayStatics::PlaySoundAtLocation(World, ExplosionSound, EffectLocation);
 	}
 
 	if (Decal.DecalMaterial)
 	{
-		FRotator RandomDecalRotation = SurfaceHit.ImpactNormal.Rotation();
+		FRotator RandomDecalRotation = Hit.ImpactNormal.Rotation();
 		RandomDecalRotation.Roll = FMath::FRandRange(-180.0f, 180.0f);
 
-		UPrimitiveComponent* HitComp = SurfaceHit.Component.Get();
+		UPrimitiveComponent* HitComp = Hit.Component.Get();
 
-		if (HitComp && Cast<APawn>(SurfaceHit.GetActor()) == NULL)
+		if (HitComp && Cast<APawn>(Hit.GetActor()) == NULL)
 		{
-			UGameplayStatics::SpawnDecalAttached(Decal.DecalMaterial, FVector(Decal.DecalSize, Decal.DecalSize, 1.0f),
-				HitComp, SurfaceHit.BoneName,
-				SurfaceHit.ImpactPoint, RandomDecalRotation, EAttachLocation::KeepWorldPosition,
-				Decal.LifeSpan);
+			EffectManager->SpawnDecal(Decal, HitComp, Hit.BoneName, Hit.ImpactPoint, RandomDecalRotation);
 		}
 	}
+
+	if (bWithLight)
+	{
+		EffectManager->SpawnFadingLight(ExplosionLight, LightLocation, ExplosionLightFadeOut);
+	}
 }
 
 void AShooterExplosionEffect::Tick(float DeltaSeconds)
@@ -2,6 +2,7 @@
 // Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
 
 #include "Effects/ShooterImpactEffect.h"
+#include "Effects/ShooterEffectManager.h"
 #include "Kismet/GameplayStatics.h"
 #include "Sound/SoundCue.h"
 #include "Particles/ParticleSystemComponent.h"
@@ -17,32 +18,40 @@ void AShooterImpactEffect::PostInitializeComponents()
 {
 	Super::PostInitializeComponents();
 
-	UPhysicalMaterial* HitPhysMat = SurfaceHit.PhysMaterial.Get();
+	PlayImpact(GetWorld(), SurfaceHit, GetActorTransform());
+}
+
+void AShooterImpactEffect::PlayImpact(UWorld* World, const FHitResult& Hit, const FTransform& SpawnTransform) const
+{
+	UShooterEffectManager* EffectManager = UShooterEffectManager::Get(World);
+	if (EffectManager == NULL)
+	{
+		return;
+	}
+
+	UPhysicalMaterial* HitPhysMat = Hit.PhysMaterial.Get();
 	EPhysicalSurface HitSurfaceType = UPhysicalMaterial::DetermineSurfaceType(HitPhysMat);
 
 	// show particles
 	UParticleSystem* ImpactFX = GetImpactFX(HitSurfaceType);
 	if (ImpactFX)
 	{
-		UGameplayStatics::SpawnEmitterAtLocation(this, ImpactFX, GetActorLocation(), GetActorRotation());
+		EffectManager->SpawnEmitter(ImpactFX, SpawnTransform.GetLocation(), SpawnTransform.Rotator());
 	}
 
 	// play sound
 	USoundCue* ImpactSound = GetImpactSound(HitSurfaceType);
 	if (ImpactSound)
 	{
-		UGameplayStatics::PlaySoundAtLocation(this, ImpactSound, GetActorLocation());
+		UGameplayStatics::PlaySoundAtLocation(World, ImpactSound, SpawnTransform.GetLocation());
 	}
 
 	if (DefaultDecal.DecalMaterial)
 	{
-		FRotator RandomDecalRotation = SurfaceHit.ImpactNormal.Rotation();
+		FRotator RandomDecalRotation = Hit.ImpactNormal.Rotation();
 		RandomDecalRotation.Roll = FMath::FRandRange(-180.0f, 180.0f);
 
-		UGameplayStatics::SpawnDecalAttached(DefaultDecal.DecalMaterial, FVector(DefaultDecal.DecalSize, DefaultDecal.DecalSize, 1.0f),
-			SurfaceHit.Component.Get(), SurfaceHit.BoneName,
-			SurfaceHit.ImpactPoint, RandomDecalRotation, EAttachLocation::KeepWorldPosition,
-			DefaultDecal.LifeSpan);
+		EffectManager->SpawnDecal(DefaultDecal, Hit.Component.Get(), Hit.BoneName, Hit.ImpactPoint, RandomDecalRotation);
 	}
 }
 
@@ -5,6 +5,7 @@
 #include "Player/ShooterControllerInterface.h"
 #include "Player/ShooterPlayerState.h"
 #include "Player/ShooterCharacter.h"
+#include "Player/ShooterCharacterSpatialIndex.h"
 #include "GameRules/ShooterGameMode_FreeForAll.h"
 #include "GameRules/ShooterGameMode_TeamDeathmatch.h"
 #include "GameRules/ShooterGameMode_CTF.h"
@@ -125,28 +126,20 @@ bool UShooterBlueprintLibrary::AnyEnemyWithin(const AShooterCharacter* TestPawn,
 	{
 		return false;
 	}
+	UShooterCharacterSpatialIndex* SpatialIndex = TestPawn->GetWorld()->GetSubsystem<UShooterCharacterSpatialIndex>();
+	if (SpatialIndex == NULL)
+	{
+		return false;
+	}
 	const FVector ActualTestLocation = TestLocation.IsZero() ? TestPawn->GetActorLocation() : TestLocation;
-	const float RadiusSquared = Radius*Radius;
-	for (TActorIterator<AShooterCharacter> It(TestPawn->GetWorld()); It; ++It)
+	return SpatialIndex->FindCharacterInRadius(ActualTestLocation, Radius, [TestPawn, bTestLOS](AShooterCharacter* OtherPawn)
 	{
-		AShooterCharacter* OtherPawn = *It;
-		if (OtherPawn != NULL && OtherPawn != TestPawn && !OtherPawn->GetTearOff() /* (not dead) */ && TestPawn->IsEnemyFor(OtherPawn->GetController()))
+		if (OtherPawn == TestPawn || !TestPawn->IsEnemyFor(OtherPawn->GetController()))
 		{
-			const float DistanceToPawn = (ActualTestLocation - OtherPawn->GetActorLocation()).SizeSquared();
-			if (DistanceToPawn <= RadiusSquared)
-			{
-				if (bTestLOS && TestPawn->Controller != NULL && TestPawn->Controller->LineOfSightTo(OtherPawn))
-				{
-					return true;
-				}
-				if (!bTestLOS)
-				{
-					return true;
-				}
-			}
+			return false;
 		}
-	}
-	return false;
+		return !bTestLOS || (TestPawn->Controller != NULL && TestPawn->Controller->LineOfSightTo(OtherPawn));
+	}) != NULL;
 }
 
 bool UShooterBlueprintLibrary::AnyEnemyWithinLocation(AController* TestController, const float Radius, const FVector& TestLocation, const bool bTestLOS /*= true*/)
@@ -155,28 +148,20 @@ bool UShooterBlueprintLibrary::AnyEnemyWithinLocation(AController* TestControlle
 	{
 		return false;
 	}
-	const float RadiusSquared = Radius*Radius;
-	for (TActorIterator<AShooterCharacter> It(TestController->GetWorld()); It; ++It)
+	UShooterCharacterSpatialIndex* SpatialIndex = TestController->GetWorld()->GetSubsystem<UShooterCharacterSpatialIndex>();
+	IShooterControllerInterface* ControllerInterface = dynamic_cast<IShooterControllerInterface*>(TestController);
+	if (SpatialIndex == NULL || ControllerInterface == NULL)
+	{
+		return false;
+	}
+	return SpatialIndex->FindCharacterInRadius(TestLocation, Radius, [TestController, ControllerInterface, bTestLOS](AShooterCharacter* OtherPawn)
 	{
-		AShooterCharacter* OtherPawn = *It;
-		IShooterControllerInterface* ControllerInterface = dynamic_cast<IShooterControllerInterface*>(TestController);
-		if (OtherPawn && OtherPawn->GetController() && OtherPawn->GetController() != TestController && !OtherPawn->GetTearOff() /* (not dead) */ && ControllerInterface->IsEnemyFor(OtherPawn->GetController()))
+		if (OtherPawn->GetController() == NULL || OtherPawn->GetController() == TestController || !ControllerInterface->IsEnemyFor(OtherPawn->GetController()))
 		{
-			const float DistanceToPawn = (TestLocation - OtherPawn->GetActorLocation()).SizeSquared();
-			if (DistanceToPawn <= RadiusSquared)
-			{
-				if (bTestLOS && TestController->LineOfSightTo(OtherPawn))
-				{
-					return true;
-				}
-				if (!bTestLOS)
-				{
-					return true;
-				}
-			}
+			return false;
 		}
-	}
-	return false;
+		return !bTestLOS || TestController->LineOfSightTo(OtherPawn);
+	}) != NULL;
 }
 
 bool UShooterBlueprintLibrary::IsLookingAt(const class AShooterCharacter* TestPawn, FVector TestPoint, float AngleTolerance /*= 90.f*/)
@@ -213,21 +198,11 @@ bool UShooterBlueprintLibrary::AnyPawnOverlapsPoint(FVector Point, AShooterChara
 {
 	if (Character != nullptr)
 	{
-		for (TActorIterator<AShooterCharacter> It(Character->GetWorld()); It; ++It)
+		UShooterCharacterSpatialIndex* SpatialIndex = Character->GetWorld()->GetSubsystem<UShooterCharacterSpatialIndex>();
+		if (SpatialIndex)
 		{
-			AShooterCharacter* OtherPawn = *It;
-			if (OtherPawn && OtherPawn->IsAlive())
-			{
-				const float CombinedHeight = (Character->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() + OtherPawn->GetCapsuleComponent()->GetScaledCapsuleHalfHeight()) * 2.0f;
-				const float CombinedRadius = Character->GetCapsuleComponent()->GetScaledCapsuleRadius() + OtherPawn->GetCapsuleComponent()->GetScaledCapsuleRadius();
-				const FVector OtherLocation = OtherPawn->GetActorLocation();
-
-				// check if player start overlaps this pawn
-				if (FMath::Abs(Point.Z - OtherLocation.Z) < CombinedHeight && (Point - OtherLocation).Size2D() < CombinedRadius)
-				{
-					return true;
-				}
-			}
+			const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+			return SpatialIndex->AnyCharacterOverlapsCapsule(Point, Capsule->GetScaledCapsuleHalfHeight(), Capsule->GetScaledCapsuleRadius());
 		}
 	}
 	return false;
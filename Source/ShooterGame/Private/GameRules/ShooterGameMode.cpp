@@ -17,6 +17,8 @@
 #include "Engine/PlayerStartPIE.h"
 #include "UObject/ConstructorHelpers.h"
 #include "Player/ShooterCharacter.h"
+#include "Player/ShooterCharacterSpatialIndex.h"
+#include "System/ShooterReplicationPolicy.h"
 #include "Components/CapsuleComponent.h"
 
 DEFINE_LOG_CATEGORY(LogShooterGameMode);
@@ -42,6 +44,12 @@ AShooterGameMode::AShooterGameMode(const FObjectInitializer& ObjectInitializer)
 	bNeedsBotCreation = true;
 	bUseSeamlessTravel = true;
 
+	NumSpawnPointLevels = INDEX_NONE;
+	NextSpawnPointSweepTime = 0.f;
+	SpawnPointSweepInterval = 0.5f;
+	SpawnProximityRadius = 2000.f;
+	MinSemiAutoInterval = 0.08f;
+
 	GameModeInfo.GameModeName = NSLOCTEXT("Game", "UndefinedGameMode", "Undefined Game Mode");
 	GameModeInfo.GameClassName = GetClass()->GetName();
 	GameModeInfo.MinTeams=0;
@@ -93,6 +101,15 @@ void AShooterGameMode::SetAllowBots(bool bInAllowBots, int32 InMaxBots)
 	MaxBots = InMaxBots;
 }
 
+void AShooterGameMode::NetReport(float Duration)
+{
+	UShooterReplicationPolicy* ReplicationPolicy = UShooterReplicationPolicy::Get(GetWorld());
+	if (ReplicationPolicy)
+	{
+		ReplicationPolicy->StartNetReport(Duration);
+	}
+}
+
 /** Returns game session class to use */
 TSubclassOf<AGameSession> AShooterGameMode::GetGameSessionClass() const
 {
@@ -403,6 +420,11 @@ bool AShooterGameMode::CanDealDamage(class AShooterPlayerState* DamageInstigator
 	return true;
 }
 
+bool AShooterGameMode::AreTeamsEnemies(uint8 InstigatorTeam, uint8 DamagedTeam) const
+{
+	return true;
+}
+
 bool AShooterGameMode::AllowCheats(APlayerController* P)
 {
 	return true;
@@ -427,95 +449,118 @@ UClass* AShooterGameMode::GetDefaultPawnClassForController_Implementation(AContr
 /** select best spawn point for player */
 AActor* AShooterGameMode::ChoosePlayerStart_Implementation(AController* Player)
 {
-	TArray<APlayerStart*> PreferredSpawns;
-	TArray<APlayerStart*> FallbackSpawns;
-	APlayerStart* BestStart = NULL;
+	UpdateSpawnPoints();
 
-	for (TActorIterator<APlayerStart> It(GetWorld()); It; ++It)
+	// Always prefer the "Play from Here" PlayerStart, if there is one while in PIE mode
+	if (PIEStart.IsValid())
 	{
-		APlayerStart* TestSpawn = *It;
-		if (TestSpawn->IsA<APlayerStartPIE>())
-		{
-			// Always prefer the first "Play from Here" PlayerStart, if we find one while in PIE mode
-			BestStart = TestSpawn;
-			break;
-		}
-		else
+		return PIEStart.Get();
+	}
+
+	TArray<FShooterSpawnPoint*> PreferredSpawns;
+	TArray<FShooterSpawnPoint*> FallbackSpawns;
+	for (FShooterSpawnPoint& SpawnPoint : SpawnPoints)
+	{
+		if (SpawnPoint.Start.IsValid() && IsSpawnpointAllowed(SpawnPoint, Player))
 		{
-			if (IsSpawnpointAllowed(TestSpawn, Player))
+			if (SpawnPoint.bOccupied)
 			{
-				if (AnyPawnOverlapsSpawnPoint(TestSpawn, Player))
-				{
-					PreferredSpawns.Add(TestSpawn);
-				}
-				else
-				{
-					FallbackSpawns.Add(TestSpawn);
-				}
+				FallbackSpawns.Add(&SpawnPoint);
+			}
+			else
+			{
+				PreferredSpawns.Add(&SpawnPoint);
 			}
 		}
 	}
-	
-	if (BestStart == NULL)
+
+	FShooterSpawnPoint* BestSpawn = GetBestSpawnPoint(PreferredSpawns.Num() > 0 ? PreferredSpawns : FallbackSpawns, Player);
+	if (BestSpawn)
 	{
-		if (PreferredSpawns.Num() > 0)
-		{
-			BestStart = GetBestSpawnPoint(PreferredSpawns, Player);
-		}
-		else if (FallbackSpawns.Num() > 0)
-		{
-			BestStart = GetBestSpawnPoint(FallbackSpawns, Player);
-		}
+		// the next sweep sees the new pawn; until then, don't send anyone else here
+		BestSpawn->bOccupied = true;
+		return BestSpawn->Start.Get();
 	}
+	return Super::ChoosePlayerStart_Implementation(Player);
+}
 
-	return BestStart ? BestStart : Super::ChoosePlayerStart_Implementation(Player);
+bool AShooterGameMode::IsSpawnpointAllowed(const FShooterSpawnPoint& SpawnPoint, AController* Player) const
+{
+	if (Cast<AShooterAIController>(Player))
+	{
+		return SpawnPoint.bAllowBots;
+	}
+	return SpawnPoint.bAllowPlayers;
 }
 
-bool AShooterGameMode::IsSpawnpointAllowed(APlayerStart* SpawnPoint, AController* Player) const
+void AShooterGameMode::RegisterSpawnPoints()
 {
-	AShooterTeamStart* ShooterSpawnPoint = Cast<AShooterTeamStart>(SpawnPoint);
-	if (ShooterSpawnPoint)
+	SpawnPoints.Reset();
+	PIEStart = NULL;
+	NumSpawnPointLevels = GetWorld()->GetLevels().Num();
+	for (TActorIterator<APlayerStart> It(GetWorld()); It; ++It)
 	{
-		AShooterAIController* AIController = Cast<AShooterAIController>(Player);
-		if (ShooterSpawnPoint->bNotForBots && AIController)
+		APlayerStart* Start = *It;
+		if (Start->IsA<APlayerStartPIE>())
 		{
-			return false;
+			PIEStart = Start;
+			continue;
 		}
-		if (ShooterSpawnPoint->bNotForPlayers && AIController == NULL)
+		FShooterSpawnPoint& SpawnPoint = SpawnPoints[SpawnPoints.AddDefaulted()];
+		SpawnPoint.Start = Start;
+		AShooterTeamStart* TeamStart = Cast<AShooterTeamStart>(Start);
+		if (TeamStart)
 		{
-			return false;
+			SpawnPoint.SpawnTeam = TeamStart->SpawnTeam;
+			SpawnPoint.bAllowPlayers = !TeamStart->bNotForPlayers;
+			SpawnPoint.bAllowBots = !TeamStart->bNotForBots;
 		}
 	}
-	return true;
+	NextSpawnPointSweepTime = 0.f;
 }
 
-bool AShooterGameMode::AnyPawnOverlapsSpawnPoint(APlayerStart* SpawnPoint, AController* Player) const
+void AShooterGameMode::UpdateSpawnPoints()
 {
+	if (NumSpawnPointLevels != GetWorld()->GetLevels().Num())
+	{
+		RegisterSpawnPoints();
+	}
+	const float Now = GetWorld()->GetTimeSeconds();
+	if (Now < NextSpawnPointSweepTime)
+	{
+		return;
+	}
+	NextSpawnPointSweepTime = Now + SpawnPointSweepInterval;
+
 	ACharacter* MyPawn = Cast<ACharacter>(DefaultPawnClass.GetDefaultObject());
-	if (MyPawn)
+	UShooterCharacterSpatialIndex* SpatialIndex = GetWorld()->GetSubsystem<UShooterCharacterSpatialIndex>();
+	if (SpatialIndex == NULL)
 	{
-		const FVector SpawnLocation = SpawnPoint->GetActorLocation();
-		for (TActorIterator<AShooterCharacter> It(GetWorld()); It; ++It)
+		return;
+	}
+	const UCapsuleComponent* Capsule = MyPawn ? MyPawn->GetCapsuleComponent() : NULL;
+	TArray<AShooterCharacter*> NearbyCharacters;
+	for (FShooterSpawnPoint& SpawnPoint : SpawnPoints)
+	{
+		APlayerStart* Start = SpawnPoint.Start.Get();
+		if (Start == NULL)
 		{
-			AShooterCharacter* OtherPawn = *It;
-			if (OtherPawn && OtherPawn->IsAlive())
-			{
-				const float CombinedHeight = (MyPawn->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() + OtherPawn->GetCapsuleComponent()->GetScaledCapsuleHalfHeight()) * 2.0f;
-				const float CombinedRadius = MyPawn->GetCapsuleComponent()->GetScaledCapsuleRadius() + OtherPawn->GetCapsuleComponent()->GetScaledCapsuleRadius();
-				const FVector OtherLocation = OtherPawn->GetActorLocation();
+			continue;
+		}
+		const FVector Location = Start->GetActorLocation();
+		SpawnPoint.bOccupied = Capsule && SpatialIndex->AnyCharacterOverlapsCapsule(Location, Capsule->GetScaledCapsuleHalfHeight(), Capsule->GetScaledCapsuleRadius());
 
-				// check if player start overlaps this pawn
-				if (FMath::Abs(SpawnLocation.Z - OtherLocation.Z) < CombinedHeight && (SpawnLocation - OtherLocation).Size2D() < CombinedRadius)
-				{
-					return false;
-				}
-			}
+		NearbyCharacters.Reset();
+		SpatialIndex->GetCharactersInRadius(Location, SpawnProximityRadius, NearbyCharacters);
+		SpawnPoint.NearbyCharacters.Reset();
+		for (AShooterCharacter* Character : NearbyCharacters)
+		{
+			SpawnPoint.NearbyCharacters.Add(Character);
 		}
 	}
-	return true;
 }
 
-APlayerStart* AShooterGameMode::GetBestSpawnPoint(const TArray<APlayerStart*>& AvailableSpawns, AController* Player) const
+FShooterSpawnPoint* AShooterGameMode::GetBestSpawnPoint(const TArray<FShooterSpawnPoint*>& AvailableSpawns, AController* Player) const
 {
 	if (AvailableSpawns.Num() == 0)
 	{
@@ -655,6 +700,11 @@ void AShooterGameMode::RestartAllPlayers(bool bDeadOnly)
 {
 	for (FConstControllerIterator It = GetWorld()->GetControllerIterator(); It; ++It)
 	{
+		//monsters have no PlayerState; they are spawned by the game rules, and their controllers may be waiting in UShooterMonsterPool
+		if ((*It)->PlayerState == NULL)
+		{
+			continue;
+		}
 		if (!bDeadOnly)
 		{
 			RestartPlayer(It->Get());
@@ -688,27 +738,57 @@ bool AShooterGameMode::AnyPlayerHasLivesRemaining() const
 	return false;
 }
 
-void AShooterGameMode::MessagePlayers(TEnumAsByte<EMessageTypes::Type> MessageType, AController* MessageRelativeTo, const FString& InstigatorName, const FString& InstigatedName, uint8 OptionalRank, uint8 OptionalTeam) const
+void AShooterGameMode::MessagePlayers(TEnumAsByte<EMessageTypes::Type> MessageType, AController* MessageRelativeTo, const FString& InstigatorName, const FString& InstigatedName, uint8 OptionalRank, uint8 OptionalTeam)
 {
-	FGameMessage TheMessage = ShooterGameState->GetGameMessage(MessageType, OptionalRank);
-	for (FConstControllerIterator It = GetWorld()->GetControllerIterator(); It; ++It)
-	{	
+	const FGameMessage TheMessage = ShooterGameState->GetGameMessage(MessageType, OptionalRank);
+	if (TheMessage.LocalMessageText.IsEmpty() && TheMessage.RemoteMessageText.IsEmpty())
+	{
+		return;
+	}
+	if (PendingMessages.Num() == 0)
+	{
+		GetWorldTimerManager().SetTimerForNextTick(this, &AShooterGameMode::FlushPendingMessages);
+	}
+	FShooterPendingMessage& Pending = PendingMessages.AddDefaulted_GetRef();
+	Pending.Message.MessageType = MessageType;
+	Pending.Message.InstigatorName = InstigatorName;
+	Pending.Message.InstigatedName = InstigatedName;
+	Pending.Message.OptionalRank = OptionalRank;
+	Pending.Message.OptionalTeam = OptionalTeam;
+	Pending.RelativeTo = MessageRelativeTo;
+	Pending.bHasLocalText = !TheMessage.LocalMessageText.IsEmpty();
+	Pending.bHasRemoteText = !TheMessage.RemoteMessageText.IsEmpty();
+}
+
+void AShooterGameMode::FlushPendingMessages()
+{
+	TArray<FShooterSentMessage> Messages;
+	Messages.Reserve(PendingMessages.Num());
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
 		AShooterPlayerController* PC = Cast<AShooterPlayerController>(It->Get());
 		if (PC)
 		{
-			if (PC != MessageRelativeTo && !TheMessage.RemoteMessageText.IsEmpty())
+			Messages.Reset();
+			for (const FShooterPendingMessage& Pending : PendingMessages)
 			{
-				PC->ClientSendMessage(MessageType, false, InstigatorName,InstigatedName, OptionalRank, OptionalTeam);
+				const bool bRelativeToMe = Pending.RelativeTo == PC;
+				if (bRelativeToMe ? Pending.bHasLocalText : Pending.bHasRemoteText)
+				{
+					FShooterSentMessage& Message = Messages.Add_GetRef(Pending.Message);
+					Message.bRelativeToMe = bRelativeToMe;
+				}
 			}
-			else if (PC == MessageRelativeTo && !TheMessage.LocalMessageText.IsEmpty())
+			if (Messages.Num() > 0)
 			{
-				PC->ClientSendMessage(MessageType, true, InstigatorName,InstigatedName, OptionalRank, OptionalTeam);
+				PC->ClientSendMessages(Messages);
 			}
 		}
 	}
+	PendingMessages.Reset();
 }
 
-void AShooterGameMode::MessagePlayers(TEnumAsByte<EMessageTypes::Type> MessageType, AController* MessageRelativeTo, const APawn* MessageInstigator /*= NULL*/, const APawn* Instigated /*= NULL*/, uint8 OptionalRank /*= 0*/, uint8 OptionalTeam /*= 0*/) const
+void AShooterGameMode::MessagePlayers(TEnumAsByte<EMessageTypes::Type> MessageType, AController* MessageRelativeTo, const APawn* MessageInstigator /*= NULL*/, const APawn* Instigated /*= NULL*/, uint8 OptionalRank /*= 0*/, uint8 OptionalTeam /*= 0*/)
 {
 	FString InstigatorName, InstigatedName;
 	const AShooterPlayerState* InstigatorPS = MessageInstigator ? MessageInstigator->GetPlayerState<AShooterPlayerState>() : NULL;
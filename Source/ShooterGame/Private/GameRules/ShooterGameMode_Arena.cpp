@@ -105,53 +105,43 @@ void AShooterGameMode_Arena::Killed(AController* Killer, AController* KilledPlay
 	CheckMatchEnd();
 }
 
-APlayerStart* AShooterGameMode_Arena::GetBestSpawnPoint(const TArray<APlayerStart*>& AvailableSpawns, AController* Player) const
+FShooterSpawnPoint* AShooterGameMode_Arena::GetBestSpawnPoint(const TArray<FShooterSpawnPoint*>& AvailableSpawns, AController* Player) const
 {
 	if (AvailableSpawns.Num() == 0)
 	{
 		return NULL;
 	}
 
-	TArray<APlayerStart*> BestSpawnPoints;
-	//find a spawn point that isn't close to other players
-	const float MinDistToOthers = 2000.f;
-	for (int32 i = 0; i < AvailableSpawns.Num(); i++)
+	//find a spawn point that isn't close to other players, using the characters near each spawn point at the last sweep (see UpdateSpawnPoints)
+	IShooterControllerInterface* MyControllerInterface = dynamic_cast<IShooterControllerInterface*>(Player);
+	TArray<FShooterSpawnPoint*> BestSpawnPoints;
+	float FarthestDist = -1.f;
+	FShooterSpawnPoint* FarthestSpawnPoint = NULL;
+	for (FShooterSpawnPoint* SpawnPoint : AvailableSpawns)
 	{
-		const FVector SpawnPointLocation = AvailableSpawns[i]->GetActorLocation();
-		const bool AnyEnemyNearby = UShooterBlueprintLibrary::AnyEnemyWithinLocation(Player, MinDistToOthers, SpawnPointLocation, false);
-		if (!AnyEnemyNearby)
+		const FVector SpawnPointLocation = SpawnPoint->Start->GetActorLocation();
+		float NearestEnemyDist = BIG_NUMBER;
+		for (const TWeakObjectPtr<AShooterCharacter>& OtherPawn : SpawnPoint->NearbyCharacters)
 		{
-			BestSpawnPoints.Add(AvailableSpawns[i]);
-		}
-	}
-
-	if (BestSpawnPoints.Num() == 0)
-	{
-		//all spawns points have enemies within MinDistToOthers, determine which is the farthest away from enemies
-		float FarthestDist = 0.f;
-		APlayerStart* FarthestPlayerStart = NULL;
-		IShooterControllerInterface* MyControllerInterface = dynamic_cast<IShooterControllerInterface*>(Player);
-		if (MyControllerInterface)
-		{
-			for (int32 i = 0; i < AvailableSpawns.Num(); i++)
+			if (MyControllerInterface && OtherPawn.IsValid() && OtherPawn->IsAlive() && MyControllerInterface->IsEnemyFor(OtherPawn->GetController()))
 			{
-				const FVector SpawnPointLocation = AvailableSpawns[i]->GetActorLocation();
-				for (TActorIterator<AShooterCharacter> It(GetWorld()); It; ++It)
-				{
-					AShooterCharacter* OtherPawn = *It;
-					if (OtherPawn && !OtherPawn->GetTearOff() /* (not dead) */ && MyControllerInterface->IsEnemyFor(OtherPawn->GetController()))
-					{
-						const float DistToPlayer = (SpawnPointLocation - OtherPawn->GetActorLocation()).SizeSquared();
-						if (FarthestDist < DistToPlayer)
-						{
-							FarthestDist = DistToPlayer;
-							FarthestPlayerStart = AvailableSpawns[i];
-						}
-					}
-				}
+				NearestEnemyDist = FMath::Min(NearestEnemyDist, (SpawnPointLocation - OtherPawn->GetActorLocation()).SizeSquared());
 			}
-			BestSpawnPoints.Add(FarthestPlayerStart);
 		}
+		if (NearestEnemyDist == BIG_NUMBER)
+		{
+			BestSpawnPoints.Add(SpawnPoint);
+		}
+		else if (NearestEnemyDist > FarthestDist)
+		{
+			//in case all spawns points have enemies within SpawnProximityRadius, remember which is the farthest away from them
+			FarthestDist = NearestEnemyDist;
+			FarthestSpawnPoint = SpawnPoint;
+		}
+	}
+	if (BestSpawnPoints.Num() == 0 && FarthestSpawnPoint)
+	{
+		BestSpawnPoints.Add(FarthestSpawnPoint);
 	}
 
 	if (BestSpawnPoints.Num() > 0)
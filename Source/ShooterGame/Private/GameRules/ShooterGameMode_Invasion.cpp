@@ -5,11 +5,13 @@
 #include "EngineUtils.h"
 #include "Kismet/GameplayStatics.h"
 #include "FunctionLibraries/ShooterBlueprintLibrary.h"
+#include "GameRules/ShooterSpawnCandidatePool.h"
 #include "Player/ShooterCharacter.h"
 #include "Player/ShooterPlayerState.h"
 #include "Player/ShooterPersistentUser.h"
 #include "AI/ShooterAIController.h"
 #include "AI/ShooterMonsterController.h"
+#include "AI/ShooterMonsterPool.h"
 
 
 AShooterGameMode_Invasion::AShooterGameMode_Invasion()
@@ -19,6 +21,8 @@ AShooterGameMode_Invasion::AShooterGameMode_Invasion()
 	GameModeInfo.MinTeams = 2;
 	GameModeInfo.MaxTeams = 2;
 	GameModeInfo.bAddToMenu = true;
+	bWavesLoaded = false;
+	bStartMatchWhenLoaded = false;
 }
 
 void AShooterGameMode_Invasion::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
@@ -26,7 +30,16 @@ void AShooterGameMode_Invasion::InitGame(const FString& MapName, const FString&
 	Super::InitGame(MapName, Options, ErrorMessage);
 
 	NumTeams = 1;
-	Waves = UShooterPersistentUser::LoadPersistentUser2("SaveSlot1", 0)->InvasionWaves;
+	bWavesLoaded = false;
+	bStartMatchWhenLoaded = false;
+	TWeakObjectPtr<AShooterGameMode_Invasion> WeakThis(this);
+	UShooterPersistentUser::LoadPersistentUserAsync("SaveSlot1", 0, FOnPersistentUserLoaded::CreateLambda([WeakThis](UShooterPersistentUser* PersistentUser)
+	{
+		if (WeakThis.IsValid())
+		{
+			WeakThis->OnWavesLoaded(PersistentUser);
+		}
+	}));
 	RoundTime = 0;
 	bUnlimitedRoundTime = true;
 	ScoreLimit = 0;
@@ -42,6 +55,39 @@ void AShooterGameMode_Invasion::InitGameState()
 	InvasionGameState->TotalWaves = Waves.Num();
 }
 
+void AShooterGameMode_Invasion::OnWavesLoaded(UShooterPersistentUser* PersistentUser)
+{
+	if (PersistentUser)
+	{
+		Waves = PersistentUser->InvasionWaves;
+	}
+	bWavesLoaded = true;
+	if (InvasionGameState)
+	{
+		InvasionGameState->TotalWaves = Waves.Num();
+	}
+	if (bStartMatchWhenLoaded)
+	{
+		bStartMatchWhenLoaded = false;
+		StartMatch();
+	}
+}
+
+bool AShooterGameMode_Invasion::ReadyToStartMatch_Implementation()
+{
+	return bWavesLoaded && Super::ReadyToStartMatch_Implementation();
+}
+
+void AShooterGameMode_Invasion::StartMatch()
+{
+	if (!bWavesLoaded)
+	{
+		bStartMatchWhenLoaded = true;
+		return;
+	}
+	Super::StartMatch();
+}
+
 void AShooterGameMode_Invasion::PostLogin(APlayerController* NewPlayer)
 {
 	Super::PostLogin(NewPlayer);
@@ -67,8 +113,17 @@ void AShooterGameMode_Invasion::HandleMatchHasStarted()
 {
 	Super::HandleMatchHasStarted();
 
-	InvasionGameState->InvasionRemainingTime = Waves[InvasionGameState->CurrentWave].WarmupTime;
 	InvasionGameState->bWaveInProgress = false;
+	if (Waves.IsValidIndex(InvasionGameState->CurrentWave))
+	{
+		InvasionGameState->InvasionRemainingTime = Waves[InvasionGameState->CurrentWave].WarmupTime;
+	}
+	else
+	{
+		UE_LOG(LogShooterGameMode, Warning, TEXT("No invasion waves were loaded (Invasion game mode)."));
+		InvasionGameState->InvasionRemainingTime = 0;
+		CheckMatchEnd();
+	}
 }
 
 bool AShooterGameMode_Invasion::CanDealDamage(class AShooterPlayerState* DamageInstigator, class AShooterPlayerState* DamagedPlayer) const
@@ -106,6 +161,11 @@ void AShooterGameMode_Invasion::DefaultTimer()
 
 void AShooterGameMode_Invasion::StartWave()
 {
+	if (!Waves.IsValidIndex(InvasionGameState->CurrentWave))
+	{
+		CheckMatchEnd();
+		return;
+	}
 	InvasionGameState->bWaveInProgress = true;
 	InvasionGameState->InvasionRemainingTime = GetCurrWave().WaveDuration;
 	InvasionGameState->MaxMonsters = GetCurrWave().MaxMonsters;
@@ -113,12 +173,15 @@ void AShooterGameMode_Invasion::StartWave()
 	//MonstersSpawnRate is in minutes, convert it to seconds to use on the Timer
 	const float SpawnRate = 60.f / GetCurrWave().MonstersSpawnRate;
 	GetWorldTimerManager().SetTimer(SpawnMonsterHandle, this, &AShooterGameMode_Invasion::SpawnMonster, SpawnRate, true);
+
+	//start looking for hidden spawn points in the background
+	GetWorld()->GetSubsystem<UShooterSpawnCandidatePool>()->Activate();
 }
 
 void AShooterGameMode_Invasion::StopWave()
 {
 	InvasionGameState->bWaveInProgress = false;
-	InvasionGameState->InvasionRemainingTime = GetCurrWave().WarmupTime;
+	InvasionGameState->InvasionRemainingTime = Waves.IsValidIndex(InvasionGameState->CurrentWave) ? GetCurrWave().WarmupTime : 0.f;
 	InvasionGameState->TotalMonstersSpawned = 0;
 	InvasionGameState->CurrentWave++;
 
@@ -126,18 +189,16 @@ void AShooterGameMode_Invasion::StopWave()
 	CheckMatchEnd();
 
 	GetWorldTimerManager().ClearTimer(SpawnMonsterHandle);
+	GetWorld()->GetSubsystem<UShooterSpawnCandidatePool>()->Deactivate();
 
-	//kill all monsters alive, if any
+	//put all monsters alive, if any, back into the pool; they don't die, ragdoll or drop their weapons
+	UShooterMonsterPool* MonsterPool = GetWorld()->GetSubsystem<UShooterMonsterPool>();
 	for (TActorIterator<AShooterCharacter> It(GetWorld()); It; ++It)
 	{
 		AShooterCharacter* TestPawn = *It;
-		if (TestPawn)
+		if (TestPawn && TestPawn->IsAlive() && Cast<AShooterMonsterController>(TestPawn->GetController()))
 		{
-			AShooterMonsterController* MonsterController = Cast<AShooterMonsterController>(TestPawn->GetController());
-			if (MonsterController)
-			{
-				UGameplayStatics::ApplyDamage(TestPawn, MAX_FLT, MonsterController, TestPawn, UDamageType::StaticClass());
-			}
+			MonsterPool->ReleaseMonster(TestPawn);
 		}
 	}
 	InvasionGameState->RemainingMonsters = 0;
@@ -151,19 +212,28 @@ void AShooterGameMode_Invasion::StopWave()
 void AShooterGameMode_Invasion::SpawnMonster()
 {
 	FInvasionWave Wave = GetCurrWave();
-	//TSubclassOf<AShooterCharacter> RandomMonsterClass = Wave.InvasionMonsters[FMath::RandHelper(Wave.InvasionMonsters.Num())].PawnClass;
-	TSubclassOf<AShooterCharacter> RandomMonsterClass = Wave.InvasionMonsters[FMath::RandHelper(Wave.InvasionMonsters.Num())].PawnClass;
+	const FInvasionMonster& RandomMonster = Wave.InvasionMonsters[FMath::RandHelper(Wave.InvasionMonsters.Num())];
+	TSubclassOf<AShooterCharacter> RandomMonsterClass = RandomMonster.PawnClass;
 
 	FVector SpawnLocation;
 	AShooterCharacter* MonsterToCreate = Cast<AShooterCharacter>(RandomMonsterClass->GetDefaultObject());
 	if (GetSpawnPoint(SpawnLocation, MonsterToCreate))
 	{
-		FActorSpawnParameters SpawnInfo;
-		SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
-		AShooterCharacter* Monster = GetWorld()->SpawnActor<AShooterCharacter>(MonsterToCreate->GetClass(), SpawnLocation, FRotator::ZeroRotator, SpawnInfo);
+		UShooterMonsterPool* MonsterPool = GetWorld()->GetSubsystem<UShooterMonsterPool>();
+		AShooterCharacter* Monster = MonsterPool->AcquireMonster(RandomMonsterClass, SpawnLocation, FRotator::ZeroRotator);
+		if (Monster == NULL)
+		{
+			FActorSpawnParameters SpawnInfo;
+			SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+			Monster = GetWorld()->SpawnActor<AShooterCharacter>(MonsterToCreate->GetClass(), SpawnLocation, FRotator::ZeroRotator, SpawnInfo);
+		}
 		if (Monster)
 		{
-			Monster->SpawnDefaultController();
+			if (!MonsterPool->PossessMonster(Monster))
+			{
+				Monster->SpawnDefaultController();
+			}
+			Monster->ApplySpawnOverrides(RandomMonster.HealthOverride, RandomMonster.MaxWalkSpeedOverride);
 			InvasionGameState->RemainingMonsters++;
 			InvasionGameState->TotalMonstersSpawned++;
 			if (InvasionGameState->TotalMonstersSpawned >= Wave.MaxMonsters)
@@ -187,6 +257,13 @@ bool AShooterGameMode_Invasion::GetSpawnPoint(FVector& OutSpawnLocation, AShoote
 		UE_LOG(LogShooterGameMode, Warning, TEXT("Map %s has no navigation mesh. Cannot spawn monsters."), *GetWorld()->PersistentLevel->GetFullName());
 		return false;
 	}
+
+	// use a point the pool has already checked, if it has any yet
+	if (GetWorld()->GetSubsystem<UShooterSpawnCandidatePool>()->PickSpawnLocation(TestCharacter, OutSpawnLocation))
+	{
+		return true;
+	}
+
 	FNavLocation PossibleSpawnPoint;
 	// Try to look for 20 possible spawn points
 	for (int32 i = 0; i < 20; i++)
@@ -230,7 +307,7 @@ void AShooterGameMode_Invasion::Killed(AController* Killer, AController* KilledP
 	if (KilledPlayer->GetClass() == AShooterMonsterController::StaticClass())
 	{
 		InvasionGameState->RemainingMonsters--;
-		if (InvasionGameState->RemainingMonsters <= 0 && InvasionGameState->TotalMonstersSpawned >= GetCurrWave().MaxMonsters)
+		if (InvasionGameState->RemainingMonsters <= 0 && Waves.IsValidIndex(InvasionGameState->CurrentWave) && InvasionGameState->TotalMonstersSpawned >= GetCurrWave().MaxMonsters)
 		{
 			StopWave();
 		}
@@ -277,7 +354,7 @@ void AShooterGameMode_Invasion::CheckMatchEnd()
 		//players lose!
 		FinishMatch();
 	}
-	else if (InvasionGameState->CurrentWave == Waves.Num())
+	else if (InvasionGameState->CurrentWave >= Waves.Num())
 	{
 		//players win!
 		FinishMatch();
@@ -10,6 +10,7 @@
 #include "ShooterTeamStart.h"
 #include "ShooterGameInstance.h"
 #include "AI/ShooterAIController.h"
+#include "System/ShooterMapCatalog.h"
 
 AShooterGameMode_TeamDeathMatch::AShooterGameMode_TeamDeathMatch()
 {
@@ -52,58 +53,28 @@ void AShooterGameMode_TeamDeathMatch::PostLogin(APlayerController* NewPlayer)
 
 void AShooterGameMode_TeamDeathMatch::LoadAdditionalMaps(AShooterPlayerController* PC)
 {
-	class FFindMapsVisitor : public IPlatformFile::FDirectoryVisitor
+	UShooterMapCatalog* MapCatalog = UShooterMapCatalog::Get();
+	if (!MapCatalog)
 	{
-	public:
-		FFindMapsVisitor() {}
-
-		virtual bool Visit(const TCHAR* FilenameOrDirectory, bool bIsDirectory)
-		{
-			if (!bIsDirectory)
-			{
-				FString FullFilePath(FilenameOrDirectory);
-				if (FPaths::GetExtension(FullFilePath) == TEXT("umap"))
-				{
-					FString CleanFilename = FPaths::GetBaseFilename(FullFilePath);
-					CleanFilename = CleanFilename.Replace(TEXT(".umap"), TEXT(""));
-					MapsFound.Add(CleanFilename);
-				}
-			}
-			return true;
-		}
-		TArray<FString> MapsFound;
-	};
-	
-	const FString MapsFolder = FPaths::ProjectContentDir() + TEXT("Maps");
-	FFindMapsVisitor Visitor;
-	FPlatformFileManager::Get().GetPlatformFile().IterateDirectory(*MapsFolder, Visitor);
+		return;
+	}
 
 	const FString PersistentLevelName = GetWorld()->GetLevel(0)->OwningWorld->GetName();
-	for (uint8 i=1; i<=ShooterGameState->GetNumTeams(); i++)
+	TArray<FName> TeamLevels;
+	MapCatalog->GetTeamStreamingLevels(PersistentLevelName, ShooterGameState->GetNumTeams(), TeamLevels);
+	for (int32 j = 0; j < TeamLevels.Num(); j++)
 	{
-		const FString TeamLevelName = PersistentLevelName + TEXT("_") + FString::FromInt(i) + TEXT("teams");
-		for (int32 j = 0; j < Visitor.MapsFound.Num(); j++)
+		if (PC && PC->IsLocalController())
 		{
-			if (Visitor.MapsFound[j].Find(TeamLevelName) != INDEX_NONE)
-			{
-				FString PathName = TEXT("/Game/Maps/") + Visitor.MapsFound[j];// + TEXT(".") + Visitor.MapsFound[j] + TEXT(":PersistentLevel");
-				//FString PathName = Visitor.MapsFound[j].Replace
-				
-				if (PC && PC->IsLocalController())
-				{
-					FLatentActionInfo info;
-					info.UUID = j;
-					UGameplayStatics::LoadStreamLevel(this, FName(*Visitor.MapsFound[j]), true, true, info);
-				}
-				else
-				{
-					PC->ClientLoadStreamingLevel(FName(*Visitor.MapsFound[j]), j);
-				}
-				
-			}
+			FLatentActionInfo info;
+			info.UUID = j;
+			UGameplayStatics::LoadStreamLevel(this, TeamLevels[j], true, true, info);
+		}
+		else
+		{
+			PC->ClientLoadStreamingLevel(TeamLevels[j], j);
 		}
 	}
-
 }
 
 APawn* AShooterGameMode_TeamDeathMatch::SpawnDefaultPawnFor_Implementation(AController* NewPlayer, class AActor* StartSpot)
@@ -113,7 +84,12 @@ APawn* AShooterGameMode_TeamDeathMatch::SpawnDefaultPawnFor_Implementation(ACont
 
 bool AShooterGameMode_TeamDeathMatch::CanDealDamage(class AShooterPlayerState* DamageInstigator, class AShooterPlayerState* DamagedPlayer) const
 {
-	return DamageInstigator && DamagedPlayer && (DamagedPlayer == DamageInstigator || DamagedPlayer->GetTeamNum() != DamageInstigator->GetTeamNum());
+	return DamageInstigator && DamagedPlayer && (DamagedPlayer == DamageInstigator || AreTeamsEnemies(DamageInstigator->GetTeamNum(), DamagedPlayer->GetTeamNum()));
+}
+
+bool AShooterGameMode_TeamDeathMatch::AreTeamsEnemies(uint8 InstigatorTeam, uint8 DamagedTeam) const
+{
+	return InstigatorTeam != DamagedTeam;
 }
 
 int32 AShooterGameMode_TeamDeathMatch::ChooseTeam(AShooterPlayerState* ForPlayerState) const
@@ -215,13 +191,12 @@ bool AShooterGameMode_TeamDeathMatch::IsWinner(class AShooterPlayerState* Player
 	return PlayerState && !PlayerState->IsQuitter() && PlayerState->GetTeamNum() == WinnerTeam;
 }
 
-bool AShooterGameMode_TeamDeathMatch::IsSpawnpointAllowed(APlayerStart* SpawnPoint, AController* Player) const
+bool AShooterGameMode_TeamDeathMatch::IsSpawnpointAllowed(const FShooterSpawnPoint& SpawnPoint, AController* Player) const
 {
 	if (Player)
 	{
-		AShooterTeamStart* TeamStart = Cast<AShooterTeamStart>(SpawnPoint);
 		AShooterPlayerState* PlayerState = Cast<AShooterPlayerState>(Player->PlayerState);
-		if (PlayerState && TeamStart && TeamStart->SpawnTeam != PlayerState->GetTeamNum())
+		if (PlayerState && SpawnPoint.SpawnTeam != INDEX_NONE && SpawnPoint.SpawnTeam != PlayerState->GetTeamNum())
 		{
 			return false;
 		}
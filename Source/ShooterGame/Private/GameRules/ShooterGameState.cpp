@@ -6,18 +6,27 @@
 #include "UI/ShooterMessageHandler.h"
 #include "Player/ShooterPlayerController.h"
 #include "Player/ShooterPlayerState.h"
+#include "Player/ShooterCharacter.h"
+#include "EngineUtils.h"
 #include "UObject/ConstructorHelpers.h"
 #include "Net/UnrealNetwork.h"
+#include "Algo/BinarySearch.h"
 
 DEFINE_LOG_CATEGORY(LogShooterGameState);
 
 AShooterGameState::AShooterGameState()
 {
 	NumTeams = 0;
+	TotalKills = 0;
 	RemainingTime = 0;
 	bTimerPaused = false;
 	bChangeToTeamColors = false;
 	bPlayersAddTeamScore = true;
+	FirstViewableCharacter = NULL;
+	TeamRelationsGame = NULL;
+	TeamRelationsGameModeClass = NULL;
+	TeamRelationsNumTeams = INDEX_NONE;
+	TeamRelationsSize = 0;
 	
 	static ConstructorHelpers::FClassFinder<UShooterMessageHandler> MsgHandlerOb(TEXT("/Game/UI/MessageHandler.MessageHandler_C"));
 	MessageHandlerClass = MsgHandlerOb.Class;
@@ -27,6 +36,14 @@ void AShooterGameState::PostInitializeComponents()
 {
 	Super::PostInitializeComponents();
 	MessageHandlerInst = NewObject<UShooterMessageHandler>(GetTransientPackage(), MessageHandlerClass, TEXT("MsgHandler"), RF_ClassDefaultObject | RF_Transient | RF_Public | RF_MarkAsNative);
+
+	for (TActorIterator<AShooterCharacter> It(GetWorld()); It; ++It)
+	{
+		if (It->HasActorBegunPlay() && It->IsAlive())
+		{
+			AddViewableCharacter(*It);
+		}
+	}
 }
 
 void AShooterGameState::GetLifetimeReplicatedProps( TArray< FLifetimeProperty > & OutLifetimeProps ) const
@@ -37,6 +54,7 @@ void AShooterGameState::GetLifetimeReplicatedProps( TArray< FLifetimeProperty >
 	DOREPLIFETIME(AShooterGameState, RemainingTime);
 	DOREPLIFETIME(AShooterGameState, bTimerPaused);
 	DOREPLIFETIME(AShooterGameState, TeamScores);
+	DOREPLIFETIME(AShooterGameState, TotalKills);
 	
 	DOREPLIFETIME_CONDITION(AShooterGameState, bClientSideHitVerification, COND_InitialOnly);
 	DOREPLIFETIME_CONDITION(AShooterGameState, bReplicateProjectiles, COND_InitialOnly);
@@ -46,28 +64,51 @@ void AShooterGameState::GetLifetimeReplicatedProps( TArray< FLifetimeProperty >
 
 TArray<AShooterPlayerState*>  AShooterGameState::GetRankedPlayerArray(int32 TeamIndex) const
 {
-	//first, we need to go over all the PlayerStates, grab their score, and rank them
-	TMultiMap<int32, AShooterPlayerState*> SortedMap;
-	for(int32 i = 0; i < PlayerArray.Num(); ++i)
+	return GetRankedPlayers(TeamIndex);
+}
+
+const TArray<AShooterPlayerState*>& AShooterGameState::GetRankedPlayers(int32 TeamIndex) const
+{
+	if (RankedTeams.IsValidIndex(TeamIndex))
 	{
-		int32 Score = 0;
-		AShooterPlayerState* CurPlayerState = Cast<AShooterPlayerState>(PlayerArray[i]);
-		if (CurPlayerState && (CurPlayerState->GetTeamNum() == TeamIndex))
-		{
-			SortedMap.Add(FMath::TruncToInt(CurPlayerState->GetScore()), CurPlayerState);
-		}
+		return RankedTeams[TeamIndex].Players;
 	}
+	static const TArray<AShooterPlayerState*> NoPlayers;
+	return NoPlayers;
+}
 
-	//sort by the keys
-	SortedMap.KeySort(TGreater<int32>());
+void AShooterGameState::UpdatePlayerRank(AShooterPlayerState* Player)
+{
+	RemovePlayerRank(Player);
+	if (Player == NULL || Player->IsPendingKill() || !PlayerArray.Contains(Player))
+	{
+		return;
+	}
+	const int32 TeamIndex = Player->GetTeamNum();
+	if (RankedTeams.Num() <= TeamIndex)
+	{
+		RankedTeams.SetNum(TeamIndex + 1);
+	}
+	//insert after players with the same score, so ties keep their order
+	FShooterRankedTeam& Team = RankedTeams[TeamIndex];
+	const int32 Score = FMath::TruncToInt(Player->GetScore());
+	const int32 InsertIndex = Algo::UpperBound(Team.Scores, Score, TGreater<int32>());
+	Team.Players.Insert(Player, InsertIndex);
+	Team.Scores.Insert(Score, InsertIndex);
+}
 
-	//now, add them a ranked array
-	TArray<AShooterPlayerState*> RankedArray;
-	for(TMultiMap<int32, AShooterPlayerState*>::TIterator It(SortedMap); It; ++It)
+void AShooterGameState::RemovePlayerRank(AShooterPlayerState* Player)
+{
+	for (FShooterRankedTeam& Team : RankedTeams)
 	{
-		RankedArray.Add( It.Value());
-	}	
-	return RankedArray;
+		const int32 Index = Team.Players.Find(Player);
+		if (Index != INDEX_NONE)
+		{
+			Team.Players.RemoveAt(Index, 1, false);
+			Team.Scores.RemoveAt(Index, 1, false);
+			return;
+		}
+	}
 }
 
 void AShooterGameState::AddTeamScore(uint8 TeamNumber, int32 ScoreToAdd)
@@ -90,20 +131,35 @@ void AShooterGameState::InitTeamScores()
 {
 	TeamScores.Empty();
 	TeamScores.AddZeroed(NumTeams);
+	TeamKills.Empty();
+	TeamKills.AddZeroed(NumTeams);
+}
+
+void AShooterGameState::Reset()
+{
+	Super::Reset();
+	TotalKills = 0;
+	FMemory::Memzero(TeamKills.GetData(), TeamKills.Num() * sizeof(int32));
 }
 
-int32 AShooterGameState::GetTotalKills()
+int32 AShooterGameState::GetTotalKills() const
 {
-	int32 Total = 0;
-	for (APlayerState* PS : PlayerArray)
+	return TotalKills;
+}
+
+int32 AShooterGameState::GetTeamKills(uint8 TeamNum) const
+{
+	return TeamKills.IsValidIndex(TeamNum) ? TeamKills[TeamNum] : 0;
+}
+
+void AShooterGameState::AddKill(AShooterPlayerState* Killer)
+{
+	TotalKills++;
+	const uint8 KillerTeam = Killer ? Killer->GetTeamNum() : 0;
+	if (Killer && TeamKills.IsValidIndex(KillerTeam))
 	{
-		AShooterPlayerState* SPS = Cast<AShooterPlayerState>(PS);
-		if (SPS)
-		{
-			Total += SPS->GetKills();
-		}
+		TeamKills[KillerTeam]++;
 	}
-	return Total;
 }
 
 bool AShooterGameState::IsTeamGame() const
@@ -117,11 +173,23 @@ int32 AShooterGameState::GetPlayerPosition(AShooterPlayerState * Player) const
 	{
 		return 0;
 	}
-	TArray<AShooterPlayerState*> PlayersRanked;
 	const uint8 MyTeam = Player->GetTeamNum();
-	PlayersRanked = GetRankedPlayerArray(MyTeam);
-	const int32 MyPos = PlayersRanked.Find(Player) + 1;
-	return MyPos;
+	if (!RankedTeams.IsValidIndex(MyTeam))
+	{
+		return 0;
+	}
+	//binary search the player's score, then look for the player among ties
+	const FShooterRankedTeam& Team = RankedTeams[MyTeam];
+	const int32 Score = FMath::TruncToInt(Player->GetScore());
+	for (int32 i = Algo::LowerBound(Team.Scores, Score, TGreater<int32>()); i < Team.Scores.Num() && Team.Scores[i] == Score; i++)
+	{
+		if (Team.Players[i] == Player)
+		{
+			return i + 1;
+		}
+	}
+	//score changed and rank wasn't updated yet
+	return Team.Players.Find(Player) + 1;
 }
 
 int32 AShooterGameState::GetPlayersTeamPosition(AShooterPlayerState * Player) const
@@ -149,8 +217,7 @@ int32 AShooterGameState::GetNumberOfPlayers(int32 Team) const
 	{
 		return PlayerArray.Num();
 	}
-	TArray<AShooterPlayerState*> PlayerStateMap = GetRankedPlayerArray(Team);
-	return PlayerStateMap.Num();
+	return GetRankedPlayers(Team).Num();
 }
 
 class UShooterMessageHandler* AShooterGameState::GetMessageHandler() const
@@ -232,6 +299,7 @@ void AShooterGameState::RequestFinishAndExitToMainMenu()
 void AShooterGameState::AddPlayerState(APlayerState* PlayerState)
 {
 	Super::AddPlayerState(PlayerState);
+	UpdatePlayerRank(Cast<AShooterPlayerState>(PlayerState));
 	//send a notify to the local player controller
 	AShooterPlayerController* PC = GetWorld()->GetFirstPlayerController<AShooterPlayerController>();
 	if (PC)
@@ -242,6 +310,7 @@ void AShooterGameState::AddPlayerState(APlayerState* PlayerState)
 
 void AShooterGameState::RemovePlayerState(APlayerState* PlayerState)
 {
+	RemovePlayerRank(Cast<AShooterPlayerState>(PlayerState));
 	Super::RemovePlayerState(PlayerState);
 	//send a notify to the local player controller
 	AShooterPlayerController* PC = GetWorld()->GetFirstPlayerController<AShooterPlayerController>();
@@ -254,6 +323,7 @@ void AShooterGameState::RemovePlayerState(APlayerState* PlayerState)
 void AShooterGameState::ReceivedGameModeClass()
 {
 	Super::ReceivedGameModeClass();
+	UpdateTeamRelations();
 }
 
 int32 AShooterGameState::GetTeamScore(uint8 TeamNum) const
@@ -270,4 +340,134 @@ void AShooterGameState::SetNumTeams(uint8 n)
 {
 	NumTeams = n;
 	InitTeamScores();
+	UpdateTeamRelations();
+}
+
+void AShooterGameState::UpdateTeamRelations() const
+{
+	TeamRelationsGameModeClass = GameModeClass;
+	TeamRelationsNumTeams = NumTeams;
+	TeamRelationsGame = GameModeClass ? GameModeClass->GetDefaultObject<AShooterGameMode>() : NULL;
+	TeamRelationsSize = TeamRelationsGame ? FMath::Max<int32>(NumTeams, 1) : 0;
+	TeamRelations.SetNumUninitialized(TeamRelationsSize * TeamRelationsSize);
+	for (int32 InstigatorTeam = 0; InstigatorTeam < TeamRelationsSize; InstigatorTeam++)
+	{
+		for (int32 DamagedTeam = 0; DamagedTeam < TeamRelationsSize; DamagedTeam++)
+		{
+			TeamRelations[InstigatorTeam * TeamRelationsSize + DamagedTeam] = TeamRelationsGame->AreTeamsEnemies(InstigatorTeam, DamagedTeam);
+		}
+	}
+}
+
+bool AShooterGameState::AreEnemies(AShooterPlayerState* TestPlayer, AShooterPlayerState* MyPlayer) const
+{
+	if (TestPlayer == NULL || MyPlayer == NULL)
+	{
+		return true;
+	}
+	//NumTeams replicates separately from the game mode class, so either may change under the cached relations
+	if (TeamRelationsGameModeClass != GameModeClass || TeamRelationsNumTeams != NumTeams)
+	{
+		UpdateTeamRelations();
+	}
+	if (TeamRelationsGame == NULL)
+	{
+		return true;
+	}
+	const int32 TestTeam = TestPlayer->GetTeamNum();
+	const int32 MyTeam = MyPlayer->GetTeamNum();
+	if (TestTeam < TeamRelationsSize && MyTeam < TeamRelationsSize)
+	{
+		return TeamRelations[TestTeam * TeamRelationsSize + MyTeam];
+	}
+	return TeamRelationsGame->CanDealDamage(TestPlayer, MyPlayer);
+}
+
+void AShooterGameState::AddViewableCharacter(AShooterCharacter* Character)
+{
+	if (Character == NULL || ViewableCharacters.Contains(Character))
+	{
+		return;
+	}
+	FShooterViewableLink& Link = ViewableCharacters.Add(Character);
+	if (FirstViewableCharacter == NULL)
+	{
+		Link.Prev = Character;
+		Link.Next = Character;
+		FirstViewableCharacter = Character;
+		return;
+	}
+	//insert before the first one, which is the end of the ring
+	FShooterViewableLink& FirstLink = ViewableCharacters.FindChecked(FirstViewableCharacter);
+	AShooterCharacter* LastCharacter = FirstLink.Prev;
+	Link.Prev = LastCharacter;
+	Link.Next = FirstViewableCharacter;
+	FirstLink.Prev = Character;
+	ViewableCharacters.FindChecked(LastCharacter).Next = Character;
+}
+
+void AShooterGameState::RemoveViewableCharacter(AShooterCharacter* Character)
+{
+	FShooterViewableLink Link;
+	if (Character == NULL || !ViewableCharacters.RemoveAndCopyValue(Character, Link))
+	{
+		return;
+	}
+	if (Link.Next == Character)
+	{
+		//it was the only one
+		FirstViewableCharacter = NULL;
+		return;
+	}
+	ViewableCharacters.FindChecked(Link.Prev).Next = Link.Next;
+	ViewableCharacters.FindChecked(Link.Next).Prev = Link.Prev;
+	if (FirstViewableCharacter == Character)
+	{
+		FirstViewableCharacter = Link.Next;
+	}
+}
+
+bool AShooterGameState::IsViewableCharacterInTeam(const AShooterCharacter* Character, int32 TeamNum)
+{
+	//characters pooled by the server are still in the cycle on clients, with no health
+	if (!Character->IsAlive())
+	{
+		return false;
+	}
+	if (TeamNum == INDEX_NONE)
+	{
+		return true;
+	}
+	const AShooterPlayerState* CharacterPlayerState = Character->GetPlayerState<AShooterPlayerState>();
+	return CharacterPlayerState && CharacterPlayerState->GetTeamNum() == TeamNum;
+}
+
+AShooterCharacter* AShooterGameState::GetNextViewableCharacter(const AActor* Current, bool bForward, int32 TeamNum) const
+{
+	if (FirstViewableCharacter == NULL)
+	{
+		return NULL;
+	}
+	const FShooterViewableLink* CurrentLink = ViewableCharacters.Find(Cast<AShooterCharacter>(const_cast<AActor*>(Current)));
+	AShooterCharacter* Candidate;
+	if (CurrentLink)
+	{
+		Candidate = bForward ? CurrentLink->Next : CurrentLink->Prev;
+	}
+	else
+	{
+		Candidate = bForward ? FirstViewableCharacter : ViewableCharacters.FindChecked(FirstViewableCharacter).Prev;
+	}
+
+	//only skipping filtered out characters needs to step more than once
+	for (int32 i = 0; i < ViewableCharacters.Num(); i++)
+	{
+		if (IsViewableCharacterInTeam(Candidate, TeamNum))
+		{
+			return Candidate;
+		}
+		const FShooterViewableLink& Link = ViewableCharacters.FindChecked(Candidate);
+		Candidate = bForward ? Link.Next : Link.Prev;
+	}
+	return NULL;
 }
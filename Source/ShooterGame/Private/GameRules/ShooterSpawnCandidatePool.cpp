@@ -0,0 +1,182 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#include "GameRules/ShooterSpawnCandidatePool.h"
+#include "GameRules/ShooterGameMode.h"
+#include "FunctionLibraries/ShooterBlueprintLibrary.h"
+#include "Player/ShooterCharacter.h"
+#include "NavigationSystem.h"
+
+UShooterSpawnCandidatePool::UShooterSpawnCandidatePool()
+{
+	PoolSize = 32;
+	SamplesPerTick = 4;
+	ChecksPerTick = 4;
+	NextCheckIndex = 0;
+	bActive = false;
+	NextGeneration = 0;
+}
+
+void UShooterSpawnCandidatePool::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	VisibilityTraceDelegate.BindUObject(this, &UShooterSpawnCandidatePool::OnVisibilityTraceDone);
+}
+
+bool UShooterSpawnCandidatePool::IsTickable() const
+{
+	return bActive && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+TStatId UShooterSpawnCandidatePool::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterSpawnCandidatePool, STATGROUP_Tickables);
+}
+
+UWorld* UShooterSpawnCandidatePool::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+void UShooterSpawnCandidatePool::Activate()
+{
+	bActive = true;
+}
+
+void UShooterSpawnCandidatePool::Deactivate()
+{
+	bActive = false;
+	Candidates.Reset();
+	NextCheckIndex = 0;
+}
+
+void UShooterSpawnCandidatePool::Tick(float DeltaTime)
+{
+	for (int32 i = 0; i < SamplesPerTick && Candidates.Num() < PoolSize; i++)
+	{
+		const int32 Index = Candidates.AddDefaulted();
+		if (!SampleCandidate(Index))
+		{
+			Candidates.RemoveAt(Index);
+			break;
+		}
+	}
+	if (Candidates.Num() == 0)
+	{
+		return;
+	}
+
+	// monsters don't count, same as UShooterBlueprintLibrary::AnyPawnCanSeePoint
+	TArray<FVector> ViewPoints;
+	for (FConstControllerIterator It = GetWorld()->GetControllerIterator(); It; ++It)
+	{
+		AController* Controller = It->Get();
+		AShooterCharacter* Pawn = Controller ? Cast<AShooterCharacter>(Controller->GetPawn()) : NULL;
+		if (Pawn && Pawn->IsAlive() && Controller->PlayerState)
+		{
+			FVector ViewPoint;
+			FRotator UnusedRot;
+			Pawn->GetActorEyesViewPoint(ViewPoint, UnusedRot);
+			ViewPoints.Add(ViewPoint);
+		}
+	}
+
+	const int32 NumChecks = FMath::Min(ChecksPerTick, Candidates.Num());
+	for (int32 i = 0; i < NumChecks; i++)
+	{
+		NextCheckIndex = (NextCheckIndex + 1) % Candidates.Num();
+		if (Candidates[NextCheckIndex].PendingTraces == 0)
+		{
+			CheckCandidate(NextCheckIndex, ViewPoints);
+		}
+	}
+}
+
+bool UShooterSpawnCandidatePool::SampleCandidate(int32 Index)
+{
+	UNavigationSystemV1* Nav = Cast<UNavigationSystemV1>(GetWorld()->GetNavigationSystem());
+	FNavLocation NavLocation;
+	if (Nav == NULL || !Nav->GetRandomPoint(NavLocation, Nav->MainNavData))
+	{
+		return false;
+	}
+	FShooterSpawnCandidate& Candidate = Candidates[Index];
+	Candidate = FShooterSpawnCandidate();
+	Candidate.Location = NavLocation.Location;
+	Candidate.Generation = NextGeneration++;
+	return true;
+}
+
+void UShooterSpawnCandidatePool::CheckCandidate(int32 Index, const TArray<FVector>& ViewPoints)
+{
+	FShooterSpawnCandidate& Candidate = Candidates[Index];
+	if (ViewPoints.Num() == 0)
+	{
+		Candidate.bVisible = false;
+		Candidate.bValidated = true;
+		return;
+	}
+
+	//the point is on the ground, so test a bit above it
+	const FVector TestPoint = Candidate.Location + FVector(0.f, 0.f, 50.f);
+	static FName TraceTag = FName(TEXT("SpawnCandidateVisibility"));
+	const FCollisionQueryParams TraceParams(TraceTag, false);
+	const uint32 UserData = ((uint32)Index << 16) | Candidate.Generation;
+	Candidate.PendingTraces = ViewPoints.Num();
+	Candidate.bSeenInCheck = false;
+	for (const FVector& ViewPoint : ViewPoints)
+	{
+		GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, ViewPoint, TestPoint, ECC_WorldStatic, TraceParams, FCollisionResponseParams::DefaultResponseParam, &VisibilityTraceDelegate, UserData);
+	}
+}
+
+void UShooterSpawnCandidatePool::OnVisibilityTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	const int32 Index = TraceDatum.UserData >> 16;
+	if (!Candidates.IsValidIndex(Index) || Candidates[Index].Generation != (TraceDatum.UserData & 0xFFFF) || Candidates[Index].PendingTraces == 0)
+	{
+		//the candidate was picked or the pool deactivated while the trace was in flight
+		return;
+	}
+	FShooterSpawnCandidate& Candidate = Candidates[Index];
+	if (TraceDatum.OutHits.Num() == 0 || !TraceDatum.OutHits[0].bBlockingHit)
+	{
+		Candidate.bSeenInCheck = true;
+	}
+	if (--Candidate.PendingTraces == 0)
+	{
+		Candidate.bVisible = Candidate.bSeenInCheck;
+		Candidate.bValidated = true;
+	}
+}
+
+bool UShooterSpawnCandidatePool::PickSpawnLocation(AShooterCharacter* TestCharacter, FVector& OutLocation)
+{
+	int32 VisibleIndex = INDEX_NONE;
+	const int32 StartIndex = Candidates.Num() > 0 ? FMath::RandHelper(Candidates.Num()) : 0;
+	for (int32 i = 0; i < Candidates.Num(); i++)
+	{
+		const int32 Index = (StartIndex + i) % Candidates.Num();
+		const FShooterSpawnCandidate& Candidate = Candidates[Index];
+		if (!Candidate.bValidated || UShooterBlueprintLibrary::AnyPawnOverlapsPoint(Candidate.Location, TestCharacter))
+		{
+			continue;
+		}
+		if (Candidate.bVisible)
+		{
+			VisibleIndex = (VisibleIndex == INDEX_NONE) ? Index : VisibleIndex;
+			continue;
+		}
+		OutLocation = Candidate.Location;
+		SampleCandidate(Index);
+		return true;
+	}
+
+	//all checked points are in LOS of players; use any
+	if (VisibleIndex != INDEX_NONE)
+	{
+		OutLocation = Candidates[VisibleIndex].Location;
+		SampleCandidate(VisibleIndex);
+		return true;
+	}
+	return false;
+}
@@ -6,6 +6,7 @@
 #include "Items/ShooterPickup.h"
 #include "Items/ShooterItem_Powerup.h"
 #include "Net/UnrealNetwork.h"
+#include "System/ShooterReplicationPolicy.h"
 
 #define LOCTEXT_NAMESPACE "ShooterGame.Item"
 
@@ -18,6 +19,19 @@ AShooterItem::AShooterItem()
 	SetRemoteRoleForBackwardsCompat(ROLE_SimulatedProxy);
 	bReplicates = true;
 	bNetUseOwnerRelevancy = true;
+	//items only change when they change hands or their amount changes, and wake up for it
+	NetDormancy = DORM_DormantAll;
+}
+
+void AShooterItem::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	UShooterReplicationPolicy* ReplicationPolicy = UShooterReplicationPolicy::Get(GetWorld());
+	if (ReplicationPolicy && GetLocalRole() == ROLE_Authority)
+	{
+		UShooterReplicationPolicy::ApplyTier(this, ReplicationPolicy->InventoryTier);
+	}
 }
 
 void AShooterItem::SetOwningPawn(AShooterCharacter* NewOwner)
@@ -28,6 +42,7 @@ void AShooterItem::SetOwningPawn(AShooterCharacter* NewOwner)
 		SetInstigator(NewOwner);
 		// net owner for RPC calls
 		SetOwner(NewOwner);
+		FlushNetDormancy();
 	}
 }
 
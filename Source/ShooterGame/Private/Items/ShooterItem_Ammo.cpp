@@ -20,23 +20,33 @@ void AShooterItem_Ammo::InitializeAmmo(TSubclassOf<AShooterWeapon> InWeaponClass
 	{
 		AmmoAmount = Amount;
 	}
+	FlushNetDormancy();
 }
 
 int32 AShooterItem_Ammo::AddAmmo(int AddAmount)
 {
 	const int32 MissingAmmo = FMath::Max(0, WeaponClass.GetDefaultObject()->GetMaxAmmo() - AmmoAmount);
 	AddAmount = FMath::Min(AddAmount, MissingAmmo);
-	AmmoAmount += AddAmount;
+	if (AddAmount > 0)
+	{
+		AmmoAmount += AddAmount;
+		FlushNetDormancy();
+	}
 	return AddAmount;
 }
 
 void AShooterItem_Ammo::UseAmmo(int UseAmount)
 {
+	const int32 OldAmmoAmount = AmmoAmount;
 	AmmoAmount -= UseAmount;
 	if (AmmoAmount < 0)
 	{
 		AmmoAmount = 0;
 	}
+	if (AmmoAmount != OldAmmoAmount)
+	{
+		FlushNetDormancy();
+	}
 }
 
 bool AShooterItem_Ammo::IsMaxAmmo() const
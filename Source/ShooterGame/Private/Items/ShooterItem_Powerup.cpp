@@ -32,6 +32,11 @@ void AShooterItem_Powerup::Activate_Implementation()
 {
 	ActivatedTime = GetWorld()->GetTimeSeconds();
 	bIsActive = true;
+	//stay awake while active, so the Deactivate broadcast reaches clients
+	if (GetLocalRole() == ROLE_Authority)
+	{
+		SetNetDormancy(DORM_Awake);
+	}
 	GetWorldTimerManager().SetTimer(TimerUpHandle, this, &AShooterItem_Powerup::TimerUp, Duration, false);	
 	if (MyPawn)
 	{
@@ -12,6 +12,8 @@
 #include "Net/UnrealNetwork.h"
 #include "Components/CapsuleComponent.h"
 #include "Sound/SoundCue.h"
+#include "System/ShooterReplicationPolicy.h"
+#include "Items/ShooterPickupManager.h"
 
 AShooterPickup::AShooterPickup()
 {
@@ -63,6 +65,10 @@ AShooterPickup::AShooterPickup()
 	bIsActive = false;
 	PickedUpBy = NULL;
 	SpawnAtGameStart = true;
+	NumPickersAfterCleanup = 0;
+	BobHeight = 0.f;
+	BobRate = 0.5f;
+	SpinRate = 0.f;
 
 	SetCanBeDamaged(false);
 	PrimaryActorTick.bCanEverTick = true;
@@ -70,6 +76,8 @@ AShooterPickup::AShooterPickup()
 	SetRemoteRoleForBackwardsCompat(ROLE_SimulatedProxy);
 	bReplicates = true;
 	SetReplicateMovement(false);
+	//only bIsActive changes after the initial replication; PickupOnTouch and RespawnPickup wake the pickup for it
+	NetDormancy = DORM_DormantAll;
 	RespawnTimeMultipler = 1.f;
 }
 
@@ -89,6 +97,19 @@ void AShooterPickup::PostInitializeComponents()
 	{
 		MovementComp->Deactivate();
 	}
+	MovementComp->OnProjectileStop.AddDynamic(this, &AShooterPickup::OnMovementStopped);
+
+	// nothing native ticks; resting pickups are animated by UShooterPickupManager
+	if (!GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(AShooterPickup, ReceiveTick)))
+	{
+		SetActorTickEnabled(false);
+	}
+
+	UShooterReplicationPolicy* ReplicationPolicy = UShooterReplicationPolicy::Get(GetWorld());
+	if (ReplicationPolicy && GetLocalRole() == ROLE_Authority)
+	{
+		UShooterReplicationPolicy::ApplyTier(this, ReplicationPolicy->PickupTier);
+	}
 }
 
 void AShooterPickup::BeginPlay()
@@ -115,10 +136,16 @@ void AShooterPickup::BeginPlay()
 			GetWorldTimerManager().SetTimer(RespawnPickupHandle, this, &AShooterPickup_Powerup::RespawnPickup, FirstSpawnTime, false);
 		}
 	}
-	if (PickupStay)
+}
+
+void AShooterPickup::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UShooterPickupManager* PickupManager = UShooterPickupManager::Get(GetWorld());
+	if (PickupManager)
 	{
-		GetWorldTimerManager().SetTimer(CleanupPickersHandle, this, &AShooterPickup::CleanupPickers, 10.f, true);
+		PickupManager->RemovePickup(this);
 	}
+	Super::EndPlay(EndPlayReason);
 }
 
 void AShooterPickup::NotifyActorBeginOverlap(class AActor* Other)
@@ -148,25 +175,23 @@ bool AShooterPickup::CanBePickedUp(class AShooterCharacter* TestPawn)
 
 bool AShooterPickup::PawnAlreadyPickedUp(class AShooterCharacter* TestPawn)
 {
-	for (int32 i = 0; i < Pickers.Num(); i++)
-	{
-		if (Pickers[i] == TestPawn)
-			return true;
-	}
-	return false;
+	//pooled monsters are reused, so only a pickup in the pawn's current life counts
+	const int32* PickerLifeId = Pickers.Find(TestPawn);
+	return PickerLifeId && *PickerLifeId == TestPawn->GetLifeId();
 }
 
-/** removes characters that are dead or no longer exist from Pickers array */
+/** removes Pickers entries of characters that no longer exist, are dead or have since been reused from the monster pool */
 void AShooterPickup::CleanupPickers()
 {
-	for (int32 i = 0; i < Pickers.Num(); i++)
+	for (auto It = Pickers.CreateIterator(); It; ++It)
 	{
-		if (!Pickers[i] || !Pickers[i]->IsAlive())
+		AShooterCharacter* Picker = It.Key().Get();
+		if (!Picker || !Picker->IsAlive() || It.Value() != Picker->GetLifeId())
 		{
-			Pickers.RemoveAt(i);
-			i--;
+			It.RemoveCurrent();
 		}
 	}
+	NumPickersAfterCleanup = Pickers.Num();
 }
 
 void AShooterPickup::GivePickupTo(class AShooterCharacter* Pawn)
@@ -182,7 +207,12 @@ void AShooterPickup::PickupOnTouch(class AShooterCharacter* Pawn)
 		PickedUpBy = Pawn;
 		if (PickupStay)
 		{
-			Pickers.Add(Pawn);
+			Pickers.Add(Pawn, Pawn->GetLifeId());
+			// entries of dead characters never match again (a pooled pawn comes back with a new life id), so they only cost memory; sweep them as the set grows
+			if (Pickers.Num() >= FMath::Max(2 * NumPickersAfterCleanup, 16))
+			{
+				CleanupPickers();
+			}
 		}
 
 		AShooterPlayerController* PawnPC = Cast<AShooterPlayerController>(Pawn->GetController());
@@ -199,6 +229,7 @@ void AShooterPickup::PickupOnTouch(class AShooterCharacter* Pawn)
 		if (!PickupStay)
 		{
 			bIsActive = false;
+			FlushNetDormancy();
 			GetWorldTimerManager().SetTimer(RespawnPickupHandle, this, &AShooterPickup::RespawnPickup, GetRespawnTime(), false);
 		}
 
@@ -213,6 +244,7 @@ void AShooterPickup::RespawnPickup()
 {
 	bIsActive = true;
 	PickedUpBy = NULL;
+	FlushNetDormancy();
 	OnRespawned();
 
 	TArray<AActor*> OverlappingPawns;
@@ -239,6 +271,8 @@ void AShooterPickup::OnPickedUp()
 		}
 
 		PickupMeshComp->SetHiddenInGame(true);
+		UpdateIdleAnimation();
+		PickupMeshComp->SetComponentTickEnabled(false);
 	}
 
 	if (PickupSound)
@@ -263,6 +297,8 @@ void AShooterPickup::OnRespawned()
 	}
 	
 	PickupMeshComp->SetHiddenInGame(false);
+	PickupMeshComp->SetComponentTickEnabled(true);
+	UpdateIdleAnimation();
 
 	const float TimeSec = GetWorld()->GetTimeSeconds();
 	const bool bJustSpawned = CreationTime >= (TimeSec - 5.0f);
@@ -307,8 +343,34 @@ void AShooterPickup::SetVelocity_Implementation(FVector_NetQuantize10 NewVelocit
 	if (MovementComp)
 	{
 		bSimulatePhysics = true;
+		// the component lets go of CollisionComp when it stops
+		MovementComp->SetUpdatedComponent(CollisionComp);
 		MovementComp->Activate();
 		MovementComp->Velocity = NewVelocity;
+		UpdateIdleAnimation();
+	}
+}
+
+void AShooterPickup::OnMovementStopped(const FHitResult& ImpactResult)
+{
+	MovementComp->Deactivate();
+	UpdateIdleAnimation();
+}
+
+void AShooterPickup::UpdateIdleAnimation()
+{
+	UShooterPickupManager* PickupManager = UShooterPickupManager::Get(GetWorld());
+	if (PickupManager == NULL)
+	{
+		return;
+	}
+	if (bIsActive && !MovementComp->IsActive() && !IsPendingKillPending())
+	{
+		PickupManager->AddPickup(this);
+	}
+	else
+	{
+		PickupManager->RemovePickup(this);
 	}
 }
 
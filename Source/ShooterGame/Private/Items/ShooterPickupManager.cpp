@@ -0,0 +1,115 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#include "Items/ShooterPickupManager.h"
+#include "Items/ShooterPickup.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Particles/ParticleSystemComponent.h"
+
+UShooterPickupManager* UShooterPickupManager::Get(UWorld* World)
+{
+	if (World == NULL || !World->IsGameWorld() || World->GetNetMode() == NM_DedicatedServer || World->bIsTearingDown)
+	{
+		return NULL;
+	}
+	return World->GetSubsystem<UShooterPickupManager>();
+}
+
+void UShooterPickupManager::Deinitialize()
+{
+	IdlePickups.Empty();
+	Super::Deinitialize();
+}
+
+bool UShooterPickupManager::IsTickable() const
+{
+	return !HasAnyFlags(RF_ClassDefaultObject) && IdlePickups.Num() > 0;
+}
+
+TStatId UShooterPickupManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterPickupManager, STATGROUP_Tickables);
+}
+
+UWorld* UShooterPickupManager::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+void UShooterPickupManager::Tick(float DeltaTime)
+{
+	const float Now = GetWorld()->GetTimeSeconds();
+	for (int32 i = IdlePickups.Num() - 1; i >= 0; i--)
+	{
+		const FShooterIdlePickup& IdlePickup = IdlePickups[i];
+		AShooterPickup* Pickup = IdlePickup.Pickup;
+		USkeletalMeshComponent* Mesh = Pickup ? Pickup->GetPickupMesh() : NULL;
+		if (Mesh == NULL || Pickup->IsPendingKill())
+		{
+			IdlePickups.RemoveAtSwap(i);
+			continue;
+		}
+
+		// effects of pickups nobody looks at don't need simulating
+		const bool bVisible = Pickup->WasRecentlyRendered(0.5f);
+		UParticleSystemComponent* PSC = Pickup->GetPickupPSC();
+		if (PSC && PSC->IsComponentTickEnabled() != bVisible)
+		{
+			PSC->SetComponentTickEnabled(bVisible);
+		}
+		if (!bVisible)
+		{
+			continue;
+		}
+
+		if (Pickup->BobHeight > 0.f || Pickup->SpinRate != 0.f)
+		{
+			// both are functions of the world time, so skipped frames don't need catching up
+			const float BobOffset = Pickup->BobHeight * FMath::Sin((Now * Pickup->BobRate + IdlePickup.Phase) * 2.f * PI);
+			const float SpinYaw = FMath::Fmod(Now * Pickup->SpinRate + IdlePickup.Phase * 360.f, 360.f);
+			Mesh->SetRelativeLocationAndRotation(IdlePickup.BaseLocation + FVector(0.f, 0.f, BobOffset), IdlePickup.BaseRotation + FRotator(0.f, SpinYaw, 0.f));
+		}
+
+		// what the mesh tick would do for an idle animation
+		if (Mesh->SkeletalMesh)
+		{
+			Mesh->TickPose(DeltaTime, false);
+			Mesh->RefreshBoneTransforms();
+		}
+	}
+}
+
+void UShooterPickupManager::AddPickup(AShooterPickup* Pickup)
+{
+	USkeletalMeshComponent* Mesh = Pickup ? Pickup->GetPickupMesh() : NULL;
+	if (Mesh == NULL || IdlePickups.ContainsByPredicate([Pickup](const FShooterIdlePickup& IdlePickup) { return IdlePickup.Pickup == Pickup; }))
+	{
+		return;
+	}
+	FShooterIdlePickup& IdlePickup = IdlePickups[IdlePickups.AddDefaulted()];
+	IdlePickup.Pickup = Pickup;
+	IdlePickup.BaseLocation = Mesh->GetRelativeLocation();
+	IdlePickup.BaseRotation = Mesh->GetRelativeRotation();
+	IdlePickup.Phase = FMath::FRand();
+	Mesh->SetComponentTickEnabled(false);
+}
+
+void UShooterPickupManager::RemovePickup(AShooterPickup* Pickup)
+{
+	const int32 Index = IdlePickups.IndexOfByPredicate([Pickup](const FShooterIdlePickup& IdlePickup) { return IdlePickup.Pickup == Pickup; });
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+	USkeletalMeshComponent* Mesh = Pickup->GetPickupMesh();
+	if (Mesh)
+	{
+		Mesh->SetRelativeLocationAndRotation(IdlePickups[Index].BaseLocation, IdlePickups[Index].BaseRotation);
+		Mesh->SetComponentTickEnabled(true);
+	}
+	UParticleSystemComponent* PSC = Pickup->GetPickupPSC();
+	if (PSC)
+	{
+		PSC->SetComponentTickEnabled(true);
+	}
+	IdlePickups.RemoveAtSwap(Index);
+}
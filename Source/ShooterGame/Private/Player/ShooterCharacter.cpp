@@ -8,9 +8,12 @@
 #include "Items/ShooterItem_Ammo.h"
 #include "Items/ShooterItem_Powerup.h"
 #include "GameRules/ShooterGameMode.h"
+#include "GameRules/ShooterGameState.h"
 #include "Animation/AnimMontage.h"
 #include "Player/ShooterLocalPlayer.h"
 #include "Player/ShooterCharacterMovement.h"
+#include "Player/ShooterCharacterSpatialIndex.h"
+#include "Player/ShooterCorpseManager.h"
 #include "System/ShooterAnimInstance.h"
 #include "Weapons/ShooterProjectile.h"
 #include "Kismet/GameplayStatics.h"
@@ -21,6 +24,7 @@
 #include "Materials/MaterialInstanceDynamic.h"
 #include "Net/UnrealNetwork.h"
 #include "Components/CapsuleComponent.h"
+#include "Camera/PlayerCameraManager.h"
 #include "Sound/SoundCue.h"
 #include "AI/ShooterAIController.h"
 
@@ -88,6 +92,7 @@ AShooterCharacter::AShooterCharacter(const FObjectInitializer& ObjectInitializer
 	StartingWeapons.SetNumUninitialized(0);
 	bHasInfiniteAmmo = false;
 	bNeverDropInventory = false;
+	bInventoryIndexDirty = true;
 	DodgeMomentum = 1024.f;
 	DodgeZ = 0.4f;
 	WallDodgeZ = 0.2f;
@@ -102,6 +107,17 @@ AShooterCharacter::AShooterCharacter(const FObjectInitializer& ObjectInitializer
 	HeadBoneNames.Add(FName("b_neck"));
 	bShouldRespawn = true;
 	bEnablePrevNextWeaponEvent = true;
+	bInPool = false;
+	LifeId = 0;
+	BotUpdateInterval = 0.1f;
+	NearUpdateInterval = 0.05f;
+	FarUpdateInterval = 0.25f;
+	FarUpdateDistance = 5000.f;
+	PendingGameplayTime = 0.f;
+	SpellCooldownEndTime = 0.f;
+#if !UE_BUILD_SHIPPING
+	DefaultMesh1P = NULL;
+#endif
 
 	BaseTurnRate = 45.f;
 	BaseLookUpRate = 45.f;
@@ -118,6 +134,23 @@ void AShooterCharacter::BeginPlay()
 	//initialize the AllMeshes array
 	GetComponents<USkeletalMeshComponent>(AllMeshes);
 
+	SpatialIndex = GetWorld()->GetSubsystem<UShooterCharacterSpatialIndex>();
+	if (SpatialIndex && !bIsDying)
+	{
+		SpatialIndex->AddCharacter(this);
+	}
+	AShooterGameState* MyGameState = GetWorld()->GetGameState<AShooterGameState>();
+	if (MyGameState && !bIsDying)
+	{
+		MyGameState->AddViewableCharacter(this);
+	}
+
+	ReplicationPolicy = (GetLocalRole() == ROLE_Authority) ? UShooterReplicationPolicy::Get(GetWorld()) : NULL;
+	if (ReplicationPolicy)
+	{
+		UShooterReplicationPolicy::ApplyTier(this, ReplicationPolicy->CharacterTier);
+	}
+
 	CreateMeshMIDs();
 
 	// respawn effects
@@ -160,6 +193,93 @@ void AShooterCharacter::Destroyed()
 	DestroyInventory();
 }
 
+void AShooterCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (SpatialIndex)
+	{
+		SpatialIndex->RemoveCharacter(this);
+	}
+	AShooterGameState* MyGameState = GetWorld()->GetGameState<AShooterGameState>();
+	if (MyGameState)
+	{
+		MyGameState->RemoveViewableCharacter(this);
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+void AShooterCharacter::DeactivateForPool()
+{
+	StopAllWeaponFire();
+	DestroyInventory();
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+
+	if (SpatialIndex)
+	{
+		SpatialIndex->RemoveCharacter(this);
+	}
+	AShooterGameState* MyGameState = GetWorld()->GetGameState<AShooterGameState>();
+	if (MyGameState)
+	{
+		MyGameState->RemoveViewableCharacter(this);
+	}
+	//not alive, so that game rules iterating characters ignore it
+	Health = 0.f;
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->DisableMovement();
+	for (USkeletalMeshComponent* TheMesh : AllMeshes)
+	{
+		TheMesh->SetComponentTickEnabled(false);
+	}
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+	bInPool = true;
+}
+
+void AShooterCharacter::ActivateFromPool(const FVector& Location, const FRotator& Rotation)
+{
+	bInPool = false;
+	LifeId++;
+	SetActorLocationAndRotation(Location, Rotation, false, NULL, ETeleportType::TeleportPhysics);
+
+	Health = GetMaxHealth();
+	Armor = 0.f;
+	Shield = 0.f;
+	SpellCharge = 0.f;
+	LastHitBy = NULL;
+	GetCharacterMovement()->MaxWalkSpeed = GetClass()->GetDefaultObject<AShooterCharacter>()->GetCharacterMovement()->MaxWalkSpeed;
+	GetCharacterMovement()->SetDefaultMovementMode();
+	for (USkeletalMeshComponent* TheMesh : AllMeshes)
+	{
+		TheMesh->SetComponentTickEnabled(true);
+	}
+
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+	if (SpatialIndex)
+	{
+		SpatialIndex->AddCharacter(this);
+	}
+	AShooterGameState* MyGameState = GetWorld()->GetGameState<AShooterGameState>();
+	if (MyGameState)
+	{
+		MyGameState->AddViewableCharacter(this);
+	}
+	ForceNetUpdate();
+}
+
+float AShooterCharacter::GetNetPriority(const FVector& ViewPos, const FVector& ViewDir, AActor* Viewer, AActor* ViewTarget, UActorChannel* InChannel, float Time, bool bLowBandwidth)
+{
+	float Priority = Super::GetNetPriority(ViewPos, ViewDir, Viewer, ViewTarget, InChannel, Time, bLowBandwidth);
+	if (ReplicationPolicy && !bIsDying && ViewTarget != this && !IsOwnedBy(Viewer))
+	{
+		Priority *= ReplicationPolicy->GetOccludedPriorityScale(this, NetActivity, Viewer, ViewTarget, ViewPos);
+	}
+	return Priority;
+}
+
 void AShooterCharacter::PawnClientRestart()
 {
 	Super::PawnClientRestart();
@@ -243,18 +363,8 @@ bool AShooterCharacter::IsEnemyFor(AController* TestPC) const
 		return false;
 	}
 
-	AShooterPlayerState* TestPlayerState = TestPC->GetPlayerState<AShooterPlayerState>();
-	AShooterPlayerState* MyPlayerState = GetPlayerState<AShooterPlayerState>();
-
-	if (GetWorld()->GetGameState() && GetWorld()->GetGameState()->GameModeClass)
-	{
-		const AShooterGameMode* DefGame = GetWorld()->GetGameState()->GameModeClass->GetDefaultObject<AShooterGameMode>();
-		if (DefGame && MyPlayerState && TestPlayerState)
-		{
-			return DefGame->CanDealDamage(TestPlayerState, MyPlayerState);
-		}
-	}
-	return true;
+	AShooterGameState* MyGameState = GetWorld()->GetGameState<AShooterGameState>();
+	return MyGameState == NULL || MyGameState->AreEnemies(TestPC->GetPlayerState<AShooterPlayerState>(), GetPlayerState<AShooterPlayerState>());
 }
 
 
@@ -472,7 +582,14 @@ bool AShooterCharacter::Die(float KillingDamage, FDamageEvent const& DamageEvent
 	AController* const KilledPlayerController = (Controller != NULL) ? Controller : Cast<AController>(GetOwner());
 	GetWorld()->GetAuthGameMode<AShooterGameMode>()->Killed(Killer, KilledPlayerController, this, KillerWeaponClass, KillerDmgType);
 	
-	NetUpdateFrequency = GetDefault<AShooterCharacter>()->NetUpdateFrequency;
+	if (ReplicationPolicy)
+	{
+		UShooterReplicationPolicy::ApplyTier(this, ReplicationPolicy->CharacterTier);
+	}
+	else
+	{
+		NetUpdateFrequency = GetDefault<AShooterCharacter>()->NetUpdateFrequency;
+	}
 	GetCharacterMovement()->ForceReplicationUpdate();
 
 	OnDeath(KillingDamage, DamageEvent, KillerCharacter, Killer, DamageCauser);
@@ -510,6 +627,16 @@ void AShooterCharacter::OnDeath(float KillingDamage, struct FDamageEvent const&
 	TearOff();
 	bIsDying = true;
 
+	if (SpatialIndex)
+	{
+		SpatialIndex->RemoveCharacter(this);
+	}
+	AShooterGameState* MyGameState = GetWorld()->GetGameState<AShooterGameState>();
+	if (MyGameState)
+	{
+		MyGameState->RemoveViewableCharacter(this);
+	}
+
 	if (GetLocalRole() == ROLE_Authority)
 	{
 		ReplicateHit(KillingDamage, DamageEvent, PawnInstigator, DamageCauser, true);
@@ -551,7 +678,15 @@ void AShooterCharacter::OnDeath(float KillingDamage, struct FDamageEvent const&
 	GetWeapon()->GetWeaponMesh3P()->SetHiddenInGame(true, true);
 	GetWeapon()->GetWeaponMesh1P()->SetHiddenInGame(true, true);
 	GetWeapon()->OwnerDied();
-	GetWorldTimerManager().SetTimer(DestroyInventoryHandle, this, &AShooterCharacter::DestroyInventory, 1.0f, false);
+	UShooterCorpseManager* CorpseManager = UShooterCorpseManager::Get(GetWorld());
+	if (CorpseManager)
+	{
+		CorpseManager->AddCorpse(this);
+	}
+	else
+	{
+		GetWorldTimerManager().SetTimer(DestroyInventoryHandle, this, &AShooterCharacter::DestroyInventory, 1.0f, false);
+	}
 
 	if (LowHealthWarningPlayer && LowHealthWarningPlayer->IsPlaying())
 	{
@@ -685,6 +820,7 @@ void AShooterCharacter::Gib(struct FDamageEvent const& DamageEvent)
 void AShooterCharacter::SetRagdollPhysics()
 {
 	bool bInRagdoll = false;
+	UShooterCorpseManager* CorpseManager = UShooterCorpseManager::Get(GetWorld());
 
 	if (IsPendingKill())
 	{
@@ -694,6 +830,10 @@ void AShooterCharacter::SetRagdollPhysics()
 	{
 		bInRagdoll = false;
 	}
+	else if (CorpseManager && !CorpseManager->CanSimulateRagdoll())
+	{
+		bInRagdoll = false;
+	}
 	else
 	{
 		// initialize physics/etc
@@ -759,6 +899,10 @@ void AShooterCharacter::SetRagdollPhysics()
 	else
 	{
 		SetLifeSpan( 60.0f );
+		if (CorpseManager)
+		{
+			CorpseManager->OnRagdollStarted(this);
+		}
 		FPointDamageEvent ev = LastTakeHitInfo.GetPointDamageEvent();
 		RagdollEvent(LastTakeHitInfo.PawnInstigator.Get(), ev.HitInfo, ev.ShotDirection);
 	}
@@ -915,6 +1059,7 @@ void AShooterCharacter::AddWeapon(AShooterWeapon* Weapon, int32 AmmoAmount)
 	{
 		Weapon->SetOwningPawn(this);
 		Inventory.AddUnique(Weapon);
+		bInventoryIndexDirty = true;
 		const int32 NewAmmo = AmmoAmount <= -1 ? Weapon->GetInitialAmmo() : AmmoAmount;
 		GiveAmmo(Weapon->GetClass(), NewAmmo);
 		//initial clip ammo
@@ -934,6 +1079,7 @@ void AShooterCharacter::AddItem(AShooterItem* Item)
 	{
 		Item->SetOwningPawn(this);
 		Inventory.AddUnique(Item);
+		bInventoryIndexDirty = true;
 
 		AShooterWeapon* Weapon = Cast<AShooterWeapon>(Item);
 		if (Weapon)
@@ -969,6 +1115,7 @@ void AShooterCharacter::RemoveItem(AShooterItem* Item)
 			Powerup->Deactivate();
 		}
 		Inventory.RemoveSingle(Item);
+		bInventoryIndexDirty = true;
 	}
 }
 
@@ -982,40 +1129,78 @@ void AShooterCharacter::ClearInventory()
 		}
 	}
 }
-AShooterWeapon* AShooterCharacter::FindWeapon(TSubclassOf<AShooterWeapon> WeaponClass) const
+
+void AShooterCharacter::OnRep_Inventory()
 {
+	bInventoryIndexDirty = true;
+}
+
+void AShooterCharacter::UpdateInventoryIndex() const
+{
+	if (!bInventoryIndexDirty)
+	{
+		return;
+	}
+	bInventoryIndexDirty = false;
+	InventoryIndexByClass.Reset();
+	AmmoIndexByWeaponClass.Reset();
 	for (int32 i = 0; i < Inventory.Num(); i++)
 	{
-		if (Inventory[i] && Inventory[i]->IsA(WeaponClass))
+		AShooterItem* Item = Inventory[i];
+		if (Item == NULL)
+		{
+			//[client] item actor not replicated yet, try again on next lookup
+			bInventoryIndexDirty = true;
+			continue;
+		}
+		for (UClass* ItemClass = Item->GetClass(); ItemClass; ItemClass = ItemClass->GetSuperClass())
+		{
+			if (!InventoryIndexByClass.Contains(ItemClass))
+			{
+				InventoryIndexByClass.Add(ItemClass, i);
+			}
+			if (ItemClass == AShooterItem::StaticClass())
+			{
+				break;
+			}
+		}
+		AShooterItem_Ammo* Ammo = Cast<AShooterItem_Ammo>(Item);
+		if (Ammo)
 		{
-			return Cast<AShooterWeapon>(Inventory[i]);
+			if (Ammo->WeaponClass == NULL)
+			{
+				bInventoryIndexDirty = true;
+			}
+			else if (!AmmoIndexByWeaponClass.Contains(Ammo->WeaponClass))
+			{
+				AmmoIndexByWeaponClass.Add(Ammo->WeaponClass, i);
+			}
 		}
 	}
-	return nullptr;
+}
+
+AShooterWeapon* AShooterCharacter::FindWeapon(TSubclassOf<AShooterWeapon> WeaponClass) const
+{
+	return Cast<AShooterWeapon>(FindItem(WeaponClass.Get()));
 }
 
 AShooterItem* AShooterCharacter::FindItem(TSubclassOf<AShooterItem> ItemClass) const
 {
-	for (int32 i = 0; i < Inventory.Num(); i++)
-	{
-		if (Inventory[i] && Inventory[i]->IsA(ItemClass))
-		{
-			return Inventory[i];
-		}
-	}
-	return nullptr;
+	UpdateInventoryIndex();
+	const int32* Index = InventoryIndexByClass.Find(ItemClass.Get());
+	return Index && Inventory.IsValidIndex(*Index) ? Inventory[*Index] : nullptr;
+}
+
+AShooterItem_Ammo* AShooterCharacter::FindAmmo(TSubclassOf<AShooterWeapon> WeaponClass) const
+{
+	UpdateInventoryIndex();
+	const int32* Index = AmmoIndexByWeaponClass.Find(WeaponClass.Get());
+	return Index && Inventory.IsValidIndex(*Index) ? Cast<AShooterItem_Ammo>(Inventory[*Index]) : nullptr;
 }
 
 AShooterItem_Powerup* AShooterCharacter::GetFirstPowerup() const
 {	
-	for (int32 i = 0; i < Inventory.Num(); i++)
-	{
-		if (Inventory[i] && Inventory[i]->IsA(AShooterItem_Powerup::StaticClass()))
-		{
-			return Cast<AShooterItem_Powerup>(Inventory[i]);
-		}
-	}
-	return NULL;
+	return Cast<AShooterItem_Powerup>(FindItem(AShooterItem_Powerup::StaticClass()));
 }
 
 AShooterWeapon* AShooterCharacter::GetBestWeapon(float AIMinWeaponRangeSquared)
@@ -1041,36 +1226,18 @@ int32 AShooterCharacter::GetCurrentAmmo(TSubclassOf<AShooterWeapon> WeaponClass,
 	{
 		return Weap->GetCurrentAmmoInClip();
 	}
-	for (int32 i = 0; i < Inventory.Num(); i++)
-	{
-		if (Inventory[i])
-		{
-			AShooterItem_Ammo* Ammo = Cast<AShooterItem_Ammo>(Inventory[i]);
-			if (Ammo && Ammo->WeaponClass == WeaponClass)
-			{
-				return Ammo->GetAmmoAmount();
-			}
-		}
-	}
-
-	return 0;
+	AShooterItem_Ammo* Ammo = FindAmmo(WeaponClass);
+	return Ammo ? Ammo->GetAmmoAmount() : 0;
 }
 
 void AShooterCharacter::UseAmmo(TSubclassOf<AShooterWeapon> WeaponClass, int32 AmmoToConsume)
 {
 	if (GetLocalRole() == ROLE_Authority && !bHasInfiniteAmmo)
 	{
-		for (int32 i = 0; i < Inventory.Num(); i++)
+		AShooterItem_Ammo* Ammo = FindAmmo(WeaponClass);
+		if (Ammo)
 		{
-			if (Inventory[i])
-			{
-				AShooterItem_Ammo* Ammo = Cast<AShooterItem_Ammo>(Inventory[i]);
-				if (Ammo && Ammo->WeaponClass == WeaponClass)
-				{
-					Ammo->UseAmmo(AmmoToConsume);
-					return;
-				}
-			}
+			Ammo->UseAmmo(AmmoToConsume);
 		}
 	}
 }
@@ -1079,17 +1246,11 @@ int32 AShooterCharacter::GiveAmmo(TSubclassOf<AShooterWeapon> WeaponClass, int32
 {
 	if (Amount > 0)
 	{
-		for (int32 i = 0; i < Inventory.Num(); i++)
+		AShooterItem_Ammo* Ammo = FindAmmo(WeaponClass);
+		if (Ammo)
 		{
-			if (Inventory[i])
-			{
-				AShooterItem_Ammo* Ammo = Cast<AShooterItem_Ammo>(Inventory[i]);
-				if (Ammo && Ammo->WeaponClass == WeaponClass)
-				{
-					//already has ammo item. Update amount.
-					return Ammo->AddAmmo(Amount);
-				}
-			}
+			//already has ammo item. Update amount.
+			return Ammo->AddAmmo(Amount);
 		}
 		//doesn't have ammo item yet, create it
 		FActorSpawnParameters SpawnInfo;
@@ -1108,17 +1269,11 @@ bool AShooterCharacter::CanPickupAmmo(TSubclassOf<AShooterWeapon> WeaponClass)
 	{
 		return false;
 	}
-	for (int32 i = 0; i < Inventory.Num(); i++)
+	AShooterItem_Ammo* Ammo = FindAmmo(WeaponClass);
+	if (Ammo)
 	{
-		if (Inventory[i])
-		{
-			AShooterItem_Ammo* Ammo = Cast<AShooterItem_Ammo>(Inventory[i]);
-			if (Ammo && Ammo->WeaponClass == WeaponClass)
-			{
-				//already has ammo item. Check ammo amount
-				return !Ammo->IsMaxAmmo();
-			}
-		}
+		//already has ammo item. Check ammo amount
+		return !Ammo->IsMaxAmmo();
 	}
 	//doesn't have that ammo yet, so it is zero and can be picked up
 	return true;
@@ -1678,18 +1833,20 @@ void AShooterCharacter::Tick(float DeltaSeconds)
 {
 	Super::Tick(DeltaSeconds);
 
-	CurrentSpellCooldownTime = FMath::Max(CurrentSpellCooldownTime - DeltaSeconds, 0.f);
-	CurrentSpellCooldownTimeNormalized = CurrentSpellCooldownTime / LastSpellCooldownTime;
+	if (SpatialIndex && !bIsDying)
+	{
+		SpatialIndex->UpdateCharacter(this);
+	}
 
 	if (GetLocalRole() == ROLE_Authority)
 	{
-		if (ShieldDecayRate > 0.f && GetWorld()->GetTimeSeconds() - ShieldDecaysAfter > LastShieldGainTime)
+		if (GetNetMode() != NM_Standalone)
 		{
-			Shield = FMath::Max(Shield - ShieldDecayRate * DeltaSeconds, 0.f);
+			PositionHistory.Record(GetWorld()->GetTimeSeconds(), GetActorLocation());
 		}
-		if (SpellChargeDecayRate > 0.f && GetWorld()->GetTimeSeconds() - SpellChargeDecaysAfter > LastSpellChargeGainTime)
+		if (ReplicationPolicy && !bIsDying)
 		{
-			SpellCharge = FMath::Max(SpellCharge - SpellChargeDecayRate * DeltaSeconds, 0.f);
+			ReplicationPolicy->UpdateCharacterRate(this, NetActivity);
 		}
 	}
 
@@ -1697,6 +1854,83 @@ void AShooterCharacter::Tick(float DeltaSeconds)
 	{
 		SetRunning(false, false);
 	}
+
+	PendingGameplayTime += DeltaSeconds;
+	if (PendingGameplayTime >= GetGameplayUpdateInterval())
+	{
+		FlushGameplayTimers();
+	}
+
+	if (bUpdateAimingDispersion)
+	{
+		CurrentAimingDispersion = FMath::Max(CurrentAimingDispersion - AimingDispersionDecrement * DeltaSeconds, MinAimingDispersion);
+	}
+
+#if !UE_BUILD_SHIPPING
+	if (IsFirstPerson())
+	{
+		if (DefaultMesh1P == NULL)
+		{
+			DefaultMesh1P = Cast<USkeletalMeshComponent>(GetClass()->GetDefaultSubobjectByName(TEXT("PawnMesh1P")));
+		}
+		Mesh1P->SetRelativeLocation(DefaultMesh1P->GetRelativeLocation());
+		Mesh1P->SetRelativeRotation(DefaultMesh1P->GetRelativeRotation());
+	}
+#endif
+}
+
+float AShooterCharacter::GetGameplayUpdateInterval() const
+{
+	if (IsLocallyControlled() && IsPlayerControlled())
+	{
+		return 0.f;
+	}
+	if (GetLocalRole() == ROLE_Authority && Controller)
+	{
+		return IsPlayerControlled() ? NearUpdateInterval : BotUpdateInterval;
+	}
+	if (!WasRecentlyRendered(0.2f))
+	{
+		return FarUpdateInterval;
+	}
+	APlayerController* LocalPC = GetWorld()->GetFirstPlayerController();
+	if (LocalPC && LocalPC->PlayerCameraManager && FVector::DistSquared(LocalPC->PlayerCameraManager->GetCameraLocation(), GetActorLocation()) > FMath::Square(FarUpdateDistance))
+	{
+		return FarUpdateInterval;
+	}
+	return NearUpdateInterval;
+}
+
+void AShooterCharacter::FlushGameplayTimers()
+{
+	if (PendingGameplayTime > 0.f)
+	{
+		UpdateGameplayTimers(PendingGameplayTime);
+		PendingGameplayTime = 0.f;
+	}
+}
+
+void AShooterCharacter::UpdateGameplayTimers(float DeltaSeconds)
+{
+	const float Now = GetWorld()->GetTimeSeconds();
+	CurrentSpellCooldownTime = FMath::Max(SpellCooldownEndTime - Now, 0.f);
+	CurrentSpellCooldownTimeNormalized = CurrentSpellCooldownTime / LastSpellCooldownTime;
+
+	if (GetLocalRole() == ROLE_Authority)
+	{
+		// decay may have started partway through DeltaSeconds; gains flush the timers first, so they can't happen within it
+		const float ShieldDecayTime = FMath::Min(DeltaSeconds, Now - ShieldDecaysAfter - LastShieldGainTime);
+		if (ShieldDecayRate > 0.f && ShieldDecayTime > 0.f)
+		{
+			Shield = FMath::Max(Shield - ShieldDecayRate * ShieldDecayTime, 0.f);
+		}
+		const float SpellChargeDecayTime = FMath::Min(DeltaSeconds, Now - SpellChargeDecaysAfter - LastSpellChargeGainTime);
+		if (SpellChargeDecayRate > 0.f && SpellChargeDecayTime > 0.f)
+		{
+			SpellCharge = FMath::Max(SpellCharge - SpellChargeDecayRate * SpellChargeDecayTime, 0.f);
+		}
+	}
+
 	AShooterPlayerController* MyPC = Cast<AShooterPlayerController>(Controller);
 	if (MyPC && MyPC->HasHealthRegen())
 	{
@@ -1729,20 +1963,6 @@ void AShooterCharacter::Tick(float DeltaSeconds)
 			LowHealthWarningPlayer->SetVolumeMultiplier(MinVolume + (1.0f - MinVolume) * VolumeMultiplier);
 		}
 	}
-
-	if (bUpdateAimingDispersion)
-	{
-		CurrentAimingDispersion = FMath::Max(CurrentAimingDispersion - AimingDispersionDecrement * DeltaSeconds, MinAimingDispersion);
-	}
-
-#if !UE_BUILD_SHIPPING
-	if (IsFirstPerson())
-	{
-		USkeletalMeshComponent* DefMesh1P = Cast<USkeletalMeshComponent>(GetClass()->GetDefaultSubobjectByName(TEXT("PawnMesh1P")));
-		Mesh1P->SetRelativeLocation(DefMesh1P->GetRelativeLocation());
-		Mesh1P->SetRelativeRotation(DefMesh1P->GetRelativeRotation());
-	}
-#endif
 }
 
 void AShooterCharacter::OnStartJump()
@@ -1835,11 +2055,13 @@ void AShooterCharacter::CastSpell(float CooldownTime, bool bUseOvercast)
 	{
 		if (bUseOvercast && CanCastOvercastSpell())
 		{
+			FlushGameplayTimers();
 			SpellCharge = 0.f;
 			LastSpellChargeGainTime = GetWorld()->GetTimeSeconds();
 		}
 		LastSpellCooldownTime = CooldownTime;
 		CurrentSpellCooldownTime = CooldownTime;
+		SpellCooldownEndTime = GetWorld()->GetTimeSeconds() + CooldownTime;
 	}
 }
 
@@ -1853,6 +2075,7 @@ void AShooterCharacter::AddSpellCharge(float Amount)
 
 void AShooterCharacter::Exec_AddSpellCharge_Implementation(float Amount)
 {
+	FlushGameplayTimers();
 	SpellCharge = FMath::Clamp(SpellCharge + Amount, 0.f, 100.f);
 	LastSpellChargeGainTime = GetWorld()->GetTimeSeconds();
 }
@@ -1873,7 +2096,7 @@ void AShooterCharacter::AddSpellChargeOnKill(AShooterCharacter* KilledCharacter)
 
 bool AShooterCharacter::CanCastSpell() const
 {
-	return CurrentSpellCooldownTime == 0.f;
+	return GetWorld()->GetTimeSeconds() >= SpellCooldownEndTime;
 }
 
 bool AShooterCharacter::CanCastOvercastSpell() const
@@ -1891,6 +2114,18 @@ float AShooterCharacter::GetMaxBoostedHealth() const
 	return MaxBoostedHealth;
 }
 
+void AShooterCharacter::ApplySpawnOverrides(float NewHealth, float NewMaxWalkSpeed)
+{
+	if (NewHealth > 0.f)
+	{
+		Health = NewHealth;
+	}
+	if (NewMaxWalkSpeed > 0.f)
+	{
+		GetCharacterMovement()->MaxWalkSpeed = NewMaxWalkSpeed;
+	}
+}
+
 float AShooterCharacter::GetHealth() const
 {
 	return Health;
@@ -2036,6 +2271,7 @@ void AShooterCharacter::GiveShield(float Amount)
 {
 	if (GetLocalRole() == ROLE_Authority)
 	{
+		FlushGameplayTimers();
 		Shield = FMath::Min(Shield + Amount, MaxShield);
 		LastShieldGainTime = GetWorld()->GetTimeSeconds();
 	}
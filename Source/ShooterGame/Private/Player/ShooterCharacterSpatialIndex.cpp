@@ -0,0 +1,264 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#include "Player/ShooterCharacterSpatialIndex.h"
+#include "Player/ShooterCharacter.h"
+#include "Components/CapsuleComponent.h"
+
+const float UShooterCharacterSpatialIndex::CellSize = 1024.f;
+
+namespace
+{
+	/** character found by a closest character query, ordered by distance */
+	struct FClosestCandidate
+	{
+		float DistSq;
+		AShooterCharacter* Character;
+
+		FClosestCandidate(float InDistSq, AShooterCharacter* InCharacter)
+			: DistSq(InDistSq)
+			, Character(InCharacter)
+		{
+		}
+
+		bool operator<(const FClosestCandidate& Other) const
+		{
+			return DistSq < Other.DistSq;
+		}
+	};
+
+	/** calls Func for every occupied cell between MinCell and MaxCell (inclusive). Walks the occupied cells instead when that's cheaper. */
+	template<typename FuncType>
+	void ForEachCellInBox(const TMap<FIntPoint, FShooterCharacterGridCell>& Cells, const FIntPoint& MinCell, const FIntPoint& MaxCell, FuncType Func)
+	{
+		const int64 BoxCells = int64(MaxCell.X - MinCell.X + 1) * int64(MaxCell.Y - MinCell.Y + 1);
+		if (BoxCells > Cells.Num())
+		{
+			for (const auto& CellPair : Cells)
+			{
+				if (CellPair.Key.X >= MinCell.X && CellPair.Key.X <= MaxCell.X && CellPair.Key.Y >= MinCell.Y && CellPair.Key.Y <= MaxCell.Y)
+				{
+					if (!Func(CellPair.Value))
+					{
+						return;
+					}
+				}
+			}
+			return;
+		}
+		for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+			{
+				const FShooterCharacterGridCell* Cell = Cells.Find(FIntPoint(X, Y));
+				if (Cell && !Func(*Cell))
+				{
+					return;
+				}
+			}
+		}
+	}
+}
+
+void UShooterCharacterSpatialIndex::Deinitialize()
+{
+	Cells.Empty();
+	CharacterCells.Empty();
+	Super::Deinitialize();
+}
+
+FIntPoint UShooterCharacterSpatialIndex::GetCellFor(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+bool UShooterCharacterSpatialIndex::IsValidCandidate(const AShooterCharacter* Character)
+{
+	return Character && !Character->IsPendingKill() && !Character->GetTearOff() && Character->IsAlive();
+}
+
+void UShooterCharacterSpatialIndex::AddCharacter(AShooterCharacter* Character)
+{
+	if (Character == NULL || CharacterCells.Contains(Character))
+	{
+		return;
+	}
+	const FIntPoint Cell = GetCellFor(Character->GetActorLocation());
+	CharacterCells.Add(Character, Cell);
+	Cells.FindOrAdd(Cell).Characters.Add(Character);
+
+	MaxCapsuleRadius = FMath::Max(MaxCapsuleRadius, Character->GetCapsuleComponent()->GetScaledCapsuleRadius());
+}
+
+void UShooterCharacterSpatialIndex::RemoveCharacter(AShooterCharacter* Character)
+{
+	FIntPoint Cell;
+	if (!CharacterCells.RemoveAndCopyValue(Character, Cell))
+	{
+		return;
+	}
+	FShooterCharacterGridCell* GridCell = Cells.Find(Cell);
+	if (GridCell)
+	{
+		GridCell->Characters.RemoveSingleSwap(Character, false);
+		if (GridCell->Characters.Num() == 0)
+		{
+			Cells.Remove(Cell);
+		}
+	}
+}
+
+void UShooterCharacterSpatialIndex::UpdateCharacter(AShooterCharacter* Character)
+{
+	FIntPoint* CurrentCell = CharacterCells.Find(Character);
+	if (CurrentCell == NULL)
+	{
+		return;
+	}
+	const FIntPoint NewCell = GetCellFor(Character->GetActorLocation());
+	if (NewCell == *CurrentCell)
+	{
+		return;
+	}
+	FShooterCharacterGridCell* OldGridCell = Cells.Find(*CurrentCell);
+	if (OldGridCell)
+	{
+		OldGridCell->Characters.RemoveSingleSwap(Character, false);
+		if (OldGridCell->Characters.Num() == 0)
+		{
+			Cells.Remove(*CurrentCell);
+		}
+	}
+	*CurrentCell = NewCell;
+	Cells.FindOrAdd(NewCell).Characters.Add(Character);
+}
+
+void UShooterCharacterSpatialIndex::GetCharactersInRadius(const FVector& Center, float Radius, TArray<AShooterCharacter*>& OutCharacters) const
+{
+	FindCharacterInRadius(Center, Radius, [&OutCharacters](AShooterCharacter* Character)
+	{
+		OutCharacters.Add(Character);
+		return false;
+	});
+}
+
+AShooterCharacter* UShooterCharacterSpatialIndex::FindCharacterInRadius(const FVector& Center, float Radius, TFunctionRef<bool(AShooterCharacter*)> Predicate) const
+{
+	if (Radius <= 0.f)
+	{
+		return NULL;
+	}
+	const float RadiusSquared = Radius * Radius;
+	const FVector Extent(Radius, Radius, 0.f);
+	AShooterCharacter* Result = NULL;
+	ForEachCellInBox(Cells, GetCellFor(Center - Extent), GetCellFor(Center + Extent), [&](const FShooterCharacterGridCell& Cell)
+	{
+		for (AShooterCharacter* Character : Cell.Characters)
+		{
+			if (IsValidCandidate(Character) && (Character->GetActorLocation() - Center).SizeSquared() <= RadiusSquared && Predicate(Character))
+			{
+				Result = Character;
+				return false;
+			}
+		}
+		return true;
+	});
+	return Result;
+}
+
+AShooterCharacter* UShooterCharacterSpatialIndex::FindClosestCharacter(const FVector& Center, TFunctionRef<bool(AShooterCharacter*)> Predicate) const
+{
+	const FIntPoint Origin = GetCellFor(Center);
+	TArray<FClosestCandidate> Pending;
+
+	auto AddCell = [&](const FShooterCharacterGridCell& Cell)
+	{
+		for (AShooterCharacter* Character : Cell.Characters)
+		{
+			if (IsValidCandidate(Character))
+			{
+				Pending.HeapPush(FClosestCandidate((Character->GetActorLocation() - Center).SizeSquared(), Character));
+			}
+		}
+	};
+
+	// search rings of cells around Origin. After ring N, every character not yet seen is at least N * CellSize away,
+	// so closer candidates can be tested right away.
+	for (int32 Ring = 0; ; Ring++)
+	{
+		const int32 RingCells = Ring == 0 ? 1 : 8 * Ring;
+		bool bSearchedAll = false;
+		if (RingCells > Cells.Num())
+		{
+			// cheaper to gather every occupied cell that wasn't searched yet
+			for (const auto& CellPair : Cells)
+			{
+				const FIntPoint Delta = CellPair.Key - Origin;
+				if (FMath::Max(FMath::Abs(Delta.X), FMath::Abs(Delta.Y)) >= Ring)
+				{
+					AddCell(CellPair.Value);
+				}
+			}
+			bSearchedAll = true;
+		}
+		else
+		{
+			for (int32 i = -Ring; i <= Ring; i++)
+			{
+				const FIntPoint RingPoints[] = { FIntPoint(i, -Ring), FIntPoint(i, Ring), FIntPoint(-Ring, i), FIntPoint(Ring, i) };
+				// corners belong to the first pair, skip them in the second; ring 0 is a single cell
+				const int32 NumPoints = Ring == 0 ? 1 : (FMath::Abs(i) == Ring ? 2 : 4);
+				for (int32 p = 0; p < NumPoints; p++)
+				{
+					const FShooterCharacterGridCell* Cell = Cells.Find(Origin + RingPoints[p]);
+					if (Cell)
+					{
+						AddCell(*Cell);
+					}
+				}
+			}
+		}
+
+		const float SafeDist = Ring * CellSize;
+		const float SafeDistSq = bSearchedAll ? MAX_FLT : SafeDist * SafeDist;
+		while (Pending.Num() > 0 && Pending.HeapTop().DistSq <= SafeDistSq)
+		{
+			FClosestCandidate Candidate(0.f, NULL);
+			Pending.HeapPop(Candidate, false);
+			if (Predicate(Candidate.Character))
+			{
+				return Candidate.Character;
+			}
+		}
+		if (bSearchedAll)
+		{
+			return NULL;
+		}
+	}
+}
+
+bool UShooterCharacterSpatialIndex::AnyCharacterOverlapsCapsule(const FVector& Point, float HalfHeight, float Radius, const AShooterCharacter* IgnoreCharacter) const
+{
+	const float SearchRadius = Radius + MaxCapsuleRadius;
+	const FVector Extent(SearchRadius, SearchRadius, 0.f);
+	bool bOverlaps = false;
+	ForEachCellInBox(Cells, GetCellFor(Point - Extent), GetCellFor(Point + Extent), [&](const FShooterCharacterGridCell& Cell)
+	{
+		for (AShooterCharacter* Character : Cell.Characters)
+		{
+			if (Character != IgnoreCharacter && IsValidCandidate(Character))
+			{
+				const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+				const float CombinedHeight = (HalfHeight + Capsule->GetScaledCapsuleHalfHeight()) * 2.0f;
+				const float CombinedRadius = Radius + Capsule->GetScaledCapsuleRadius();
+				const FVector OtherLocation = Character->GetActorLocation();
+				if (FMath::Abs(Point.Z - OtherLocation.Z) < CombinedHeight && (Point - OtherLocation).Size2D() < CombinedRadius)
+				{
+					bOverlaps = true;
+					return false;
+				}
+			}
+		}
+		return true;
+	});
+	return bOverlaps;
+}
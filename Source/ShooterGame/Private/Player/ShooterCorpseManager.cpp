@@ -0,0 +1,159 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#include "Player/ShooterCorpseManager.h"
+#include "Player/ShooterCharacter.h"
+
+UShooterCorpseManager::UShooterCorpseManager()
+{
+	MaxSimulatingCorpses = 8;
+	MaxCorpses = 24;
+	DedicatedServerMaxSimulatingCorpses = 0;
+	DedicatedServerMaxCorpses = 8;
+	MinSimulationTime = 1.f;
+	MaxSimulationTime = 8.f;
+	SettledSpeed = 20.f;
+	OverBudgetSettledSpeed = 150.f;
+	DestroyInventoryDelay = 1.f;
+}
+
+UShooterCorpseManager* UShooterCorpseManager::Get(UWorld* World)
+{
+	if (World == NULL || !World->IsGameWorld() || World->bIsTearingDown)
+	{
+		return NULL;
+	}
+	return World->GetSubsystem<UShooterCorpseManager>();
+}
+
+bool UShooterCorpseManager::IsTickable() const
+{
+	return Corpses.Num() > 0;
+}
+
+TStatId UShooterCorpseManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterCorpseManager, STATGROUP_Tickables);
+}
+
+UWorld* UShooterCorpseManager::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+int32 UShooterCorpseManager::GetMaxSimulatingCorpses() const
+{
+	return (GetWorld()->GetNetMode() == NM_DedicatedServer) ? DedicatedServerMaxSimulatingCorpses : MaxSimulatingCorpses;
+}
+
+int32 UShooterCorpseManager::GetMaxCorpses() const
+{
+	return (GetWorld()->GetNetMode() == NM_DedicatedServer) ? DedicatedServerMaxCorpses : MaxCorpses;
+}
+
+void UShooterCorpseManager::AddCorpse(AShooterCharacter* Character)
+{
+	FShooterCorpse& Corpse = Corpses[Corpses.AddDefaulted()];
+	Corpse.Character = Character;
+	Corpse.DeathTime = GetWorld()->GetTimeSeconds();
+	//only the server has inventory to destroy
+	Corpse.bInventoryDestroyed = (Character->GetLocalRole() < ROLE_Authority);
+}
+
+bool UShooterCorpseManager::CanSimulateRagdoll() const
+{
+	return GetMaxSimulatingCorpses() > 0;
+}
+
+void UShooterCorpseManager::OnRagdollStarted(AShooterCharacter* Character)
+{
+	for (FShooterCorpse& Corpse : Corpses)
+	{
+		if (Corpse.Character.Get() == Character)
+		{
+			Corpse.bSimulating = true;
+			Corpse.RagdollStartTime = GetWorld()->GetTimeSeconds();
+			break;
+		}
+	}
+}
+
+bool UShooterCorpseManager::IsRagdollSlowerThan(const FShooterCorpse& Corpse, float Speed) const
+{
+	USkeletalMeshComponent* Mesh = Corpse.Character.IsValid() ? Corpse.Character->GetMesh() : NULL;
+	return Mesh == NULL || !Mesh->RigidBodyIsAwake() || Mesh->GetPhysicsLinearVelocity().SizeSquared() < FMath::Square(Speed);
+}
+
+void UShooterCorpseManager::EnforceSimulationBudget(int32 MaxSimulating, float Now)
+{
+	int32 NumSimulating = 0;
+	for (const FShooterCorpse& Corpse : Corpses)
+	{
+		NumSimulating += Corpse.bSimulating ? 1 : 0;
+	}
+	//ragdolls still flying through the air are skipped, so they don't freeze mid-air; they're frozen once they slow down
+	for (int32 i = 0; i < Corpses.Num() && NumSimulating > MaxSimulating; i++)
+	{
+		FShooterCorpse& Corpse = Corpses[i];
+		if (Corpse.bSimulating && Now - Corpse.RagdollStartTime >= MinSimulationTime && IsRagdollSlowerThan(Corpse, OverBudgetSettledSpeed))
+		{
+			FreezeCorpse(Corpse);
+			NumSimulating--;
+		}
+	}
+}
+
+void UShooterCorpseManager::FreezeCorpse(FShooterCorpse& Corpse)
+{
+	Corpse.bSimulating = false;
+	AShooterCharacter* Character = Corpse.Character.Get();
+	USkeletalMeshComponent* Mesh = Character ? Character->GetMesh() : NULL;
+	if (Mesh)
+	{
+		//keep the bones where the ragdoll left them; kinematic bodies can't be woken up by contacts
+		Mesh->bNoSkeletonUpdate = true;
+		Mesh->bPauseAnims = true;
+		Mesh->SetAllBodiesSimulatePhysics(false);
+		Mesh->SetComponentTickEnabled(false);
+		Character->SetActorTickEnabled(false);
+	}
+}
+
+void UShooterCorpseManager::Tick(float DeltaTime)
+{
+	const float Now = GetWorld()->GetTimeSeconds();
+	for (int32 i = Corpses.Num() - 1; i >= 0; i--)
+	{
+		FShooterCorpse& Corpse = Corpses[i];
+		AShooterCharacter* Character = Corpse.Character.Get();
+		if (Character == NULL || Character->IsPendingKill())
+		{
+			Corpses.RemoveAt(i, 1, false);
+			continue;
+		}
+		if (!Corpse.bInventoryDestroyed && Now - Corpse.DeathTime >= DestroyInventoryDelay)
+		{
+			Corpse.bInventoryDestroyed = true;
+			Character->DestroyInventory();
+		}
+		if (Corpse.bSimulating && Now - Corpse.RagdollStartTime >= MinSimulationTime)
+		{
+			if (IsRagdollSlowerThan(Corpse, SettledSpeed) || Now - Corpse.RagdollStartTime >= MaxSimulationTime)
+			{
+				FreezeCorpse(Corpse);
+			}
+		}
+	}
+
+	EnforceSimulationBudget(GetMaxSimulatingCorpses(), Now);
+
+	//remove the oldest corpses when over budget; their inventory goes with them in Destroyed()
+	const int32 NumToRemove = Corpses.Num() - GetMaxCorpses();
+	for (int32 i = 0; i < NumToRemove; i++)
+	{
+		Corpses[i].Character->Destroy();
+	}
+	if (NumToRemove > 0)
+	{
+		Corpses.RemoveAt(0, NumToRemove);
+	}
+}
@@ -29,6 +29,7 @@ void UShooterLocalPlayer::LoadPersistentUser()
 	if (PersistentUser != nullptr && ( GetControllerId() != PersistentUser->GetUserIndex() || GetNickname() != PersistentUser->GetName() ) )
 	{
 		PersistentUser->SaveIfDirty();
+		PersistentUser->FlushPendingSave();
 		PersistentUser = nullptr;
 	}
 
@@ -55,6 +56,7 @@ void UShooterLocalPlayer::SetControllerId(int32 NewControllerId)
 	if (PersistentUser != nullptr && ( GetControllerId() != PersistentUser->GetUserIndex() || GetNickname() != PersistentUser->GetName() ) )
 	{
 		PersistentUser->SaveIfDirty();
+		PersistentUser->FlushPendingSave();
 		PersistentUser = nullptr;
 	}
 
@@ -8,6 +8,8 @@
 #include "Player/ShooterCharacter.h"
 #include "Player/ShooterPlayerState.h"
 #include "Player/ShooterLocalPlayer.h"
+#include "Async/Async.h"
+#include "UObject/UObjectIterator.h"
 
 UShooterPersistentUser::UShooterPersistentUser()
 {
@@ -17,6 +19,8 @@ UShooterPersistentUser::UShooterPersistentUser()
 void UShooterPersistentUser::SetToDefaults()
 {
 	bIsDirty = false;
+	bSaveInProgress = false;
+	bSaveQueued = false;
 
 
 	bIsRecordingDemos = false;
@@ -189,8 +193,83 @@ bool IsInvertedYAxisDirty()
 
 void UShooterPersistentUser::SavePersistentUser()
 {
-	UGameplayStatics::SaveGameToSlot(this, SlotName, UserIndex);
 	bIsDirty = false;
+	if (bSaveInProgress)
+	{
+		//write the latest data once the current save is done
+		bSaveQueued = true;
+		return;
+	}
+
+	//snapshot the data now, the worker thread only writes it
+	TSharedRef<TArray<uint8>, ESPMode::ThreadSafe> SaveData = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>();
+	if (!UGameplayStatics::SaveGameToMemory(this, *SaveData))
+	{
+		OnSaveCompleted.Broadcast(false);
+		return;
+	}
+	FlushPendingSavesToSlot(SlotName, UserIndex, this);
+
+	//rooted until OnSavePersistentUserFinished, so the queued save still happens if the owner lets go of this user
+	bSaveInProgress = true;
+	AddToRoot();
+	const FString SaveSlotName = SlotName;
+	const int32 SaveUserIndex = UserIndex;
+	PendingSave = Async(EAsyncExecution::ThreadPool, [this, SaveData, SaveSlotName, SaveUserIndex]()
+	{
+		const bool bSuccess = UGameplayStatics::SaveDataToSlot(*SaveData, SaveSlotName, SaveUserIndex);
+		AsyncTask(ENamedThreads::GameThread, [this, bSuccess]()
+		{
+			OnSavePersistentUserFinished(bSuccess);
+		});
+		return bSuccess;
+	});
+}
+
+void UShooterPersistentUser::OnSavePersistentUserFinished(bool bSuccess)
+{
+	bSaveInProgress = false;
+	RemoveFromRoot();
+	if (bSaveQueued)
+	{
+		bSaveQueued = false;
+		SavePersistentUser();
+	}
+	OnSaveCompleted.Broadcast(bSuccess);
+}
+
+void UShooterPersistentUser::FlushPendingSave()
+{
+	if (!bSaveInProgress)
+	{
+		return;
+	}
+	PendingSave.Wait();
+	if (bSaveQueued)
+	{
+		//OnSavePersistentUserFinished still arrives later, and finds nothing left to do
+		bSaveQueued = false;
+		UGameplayStatics::SaveGameToSlot(this, SlotName, UserIndex);
+	}
+}
+
+void UShooterPersistentUser::FlushAllPendingSaves()
+{
+	for (TObjectIterator<UShooterPersistentUser> It; It; ++It)
+	{
+		It->FlushPendingSave();
+	}
+}
+
+void UShooterPersistentUser::FlushPendingSavesToSlot(const FString& SlotName, int32 UserIndex, const UShooterPersistentUser* Except)
+{
+	for (TObjectIterator<UShooterPersistentUser> It; It; ++It)
+	{
+		if (*It != Except && It->bSaveInProgress && It->UserIndex == UserIndex && It->SlotName == SlotName)
+		{
+			It->FlushPendingSave();
+		}
+	}
 }
 
 UShooterPersistentUser* UShooterPersistentUser::LoadPersistentUser2(FString SlotName, const int32 UserIndex)
@@ -201,6 +280,7 @@ UShooterPersistentUser* UShooterPersistentUser::LoadPersistentUser2(FString Slot
 	// Persistent users aren't valid in this state.
 	if (SlotName.Len() > 0)
 	{
+		FlushPendingSavesToSlot(SlotName, UserIndex);
 		Result = Cast<UShooterPersistentUser>(UGameplayStatics::LoadGameFromSlot(SlotName, UserIndex));
 		if (Result == NULL)
 		{
@@ -216,6 +296,33 @@ UShooterPersistentUser* UShooterPersistentUser::LoadPersistentUser2(FString Slot
 	return Result;
 }
 
+void UShooterPersistentUser::LoadPersistentUserAsync(FString SlotName, const int32 UserIndex, FOnPersistentUserLoaded Callback)
+{
+	// see LoadPersistentUser2, no slot name means no valid persistent user yet
+	if (SlotName.Len() == 0)
+	{
+		Callback.ExecuteIfBound(NULL);
+		return;
+	}
+	//don't read the slot while it's being written
+	FlushPendingSavesToSlot(SlotName, UserIndex);
+
+	UGameplayStatics::AsyncLoadGameFromSlot(SlotName, UserIndex, FAsyncLoadGameFromSlotDelegate::CreateLambda([Callback](const FString& LoadedSlotName, const int32 LoadedUserIndex, USaveGame* LoadedGame)
+	{
+		UShooterPersistentUser* Result = Cast<UShooterPersistentUser>(LoadedGame);
+		if (Result == NULL)
+		{
+			// if failed to load, create a new one
+			Result = Cast<UShooterPersistentUser>(UGameplayStatics::CreateSaveGameObject(UShooterPersistentUser::StaticClass()));
+		}
+		check(Result != NULL);
+
+		Result->SlotName = LoadedSlotName;
+		Result->UserIndex = LoadedUserIndex;
+		Callback.ExecuteIfBound(Result);
+	}));
+}
+
 void UShooterPersistentUser::SaveIfDirty()
 {
 	if (bIsDirty || IsInvertedYAxisDirty() || IsAimSensitivityDirty())
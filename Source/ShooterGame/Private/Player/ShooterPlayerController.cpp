@@ -18,6 +18,7 @@
 #include "Player/ShooterCheatManager.h"
 #include "Player/ShooterPersistentUser.h"
 #include "GameRules/ShooterGameMode.h"
+#include "GameRules/ShooterGameState.h"
 #include "ShooterLeaderboards.h"
 #include "Net/UnrealNetwork.h"
 
@@ -246,6 +247,15 @@ void AShooterPlayerController::GameHasEnded(class AActor* EndGameFocus, bool bIs
 	Super::GameHasEnded(EndGameFocus, bIsWinner);
 }
 
+void AShooterPlayerController::SpectateTeam(int32 TeamNum)
+{
+	AShooterSpectatorPawn* Spec = Cast<AShooterSpectatorPawn>(GetSpectatorPawn());
+	if (Spec)
+	{
+		Spec->SpectateTeam(TeamNum);
+	}
+}
+
 void AShooterPlayerController::ClientSetSpectatorCamera_Implementation(AActor* NewViewTarget, bool bViewTargetIsDead)
 {
 	ChangeState(NAME_Spectating);
@@ -829,6 +839,11 @@ void AShooterPlayerController::EndPlay(const EEndPlayReason::Type EndPlayReason)
 	if (PersistentUser)
 	{
 		PersistentUser->SaveIfDirty();
+		// the game may exit before an async save gets to finish
+		if (EndPlayReason == EEndPlayReason::Quit || EndPlayReason == EEndPlayReason::EndPlayInEditor)
+		{
+			PersistentUser->FlushPendingSave();
+		}
 	}
 	Super::EndPlay(EndPlayReason);
 }
@@ -1019,18 +1034,8 @@ bool AShooterPlayerController::IsEnemyFor(AController* TestPC) const
 		return false;
 	}
 
-	AShooterPlayerState* TestPlayerState = TestPC->GetPlayerState<AShooterPlayerState>();
-	AShooterPlayerState* MyPlayerState = GetPlayerState<AShooterPlayerState>();
-
-	if (TestPC->GetWorld()->GetGameState() && GetWorld()->GetGameState()->GameModeClass)
-	{
-		const AShooterGameMode* DefGame = GetWorld()->GetGameState()->GameModeClass->GetDefaultObject<AShooterGameMode>();
-		if (DefGame && MyPlayerState && TestPlayerState)
-		{
-			return DefGame->CanDealDamage(TestPlayerState, MyPlayerState);
-		}
-	}
-	return true;
+	AShooterGameState* MyGameState = GetWorld()->GetGameState<AShooterGameState>();
+	return MyGameState == NULL || MyGameState->AreEnemies(TestPC->GetPlayerState<AShooterPlayerState>(), GetPlayerState<AShooterPlayerState>());
 }
 
 void AShooterPlayerController::ToggleSpeaking(bool bSpeaking)
@@ -1139,6 +1144,14 @@ void AShooterPlayerController::ClientSendMessage_Implementation(EMessageTypes::T
 	}*/
 }
 
+void AShooterPlayerController::ClientSendMessages_Implementation(const TArray<FShooterSentMessage>& Messages)
+{
+	for (const FShooterSentMessage& Message : Messages)
+	{
+		ClientSendMessage_Implementation(Message.MessageType, Message.bRelativeToMe, Message.InstigatorName, Message.InstigatedName, Message.OptionalRank, Message.OptionalTeam);
+	}
+}
+
 void AShooterPlayerController::TalkingStateChanged(TSharedRef<const FUniqueNetId> TalkerId, bool bIsTalking)
 {
 	const int32 PreviousNumberOfTalkers = NumberOfTalkers;
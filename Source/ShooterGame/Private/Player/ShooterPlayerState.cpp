@@ -41,6 +41,27 @@ void AShooterPlayerState::Reset()
 	KillsSinceLastDeath = 0;
 	LastKillTime = -MAX_FLT;
 	MultiKills = 1;
+	UpdateRank();
+}
+
+void AShooterPlayerState::OnRep_Score()
+{
+	Super::OnRep_Score();
+	UpdateRank();
+}
+
+void AShooterPlayerState::OnRep_TeamNumber()
+{
+	UpdateRank();
+}
+
+void AShooterPlayerState::UpdateRank()
+{
+	AShooterGameState* const MyGameState = GetWorld() ? GetWorld()->GetGameState<AShooterGameState>() : NULL;
+	if (MyGameState)
+	{
+		MyGameState->UpdatePlayerRank(this);
+	}
 }
 
 void AShooterPlayerState::UnregisterPlayerWithSession()
@@ -84,6 +105,7 @@ void AShooterPlayerState::ServerSetTeamNum_Implementation(uint8 NewTeamNumber)
 	if (Game && NewTeamNumber < Game->GameModeInfo.MaxTeams)
 	{
 		TeamNumber = NewTeamNumber;
+		UpdateRank();
 		AShooterGameState* const MyGameState = GetWorld()->GetGameState<AShooterGameState>();
 		if (MyGameState)
 		{
@@ -131,9 +153,17 @@ void AShooterPlayerState::CopyProperties(class APlayerState* PlayerState)
 	if (ShooterPlayer)
 	{
 		ShooterPlayer->TeamNumber = TeamNumber;
+		//score and team were copied, e.g. on seamless travel or when an inactive player comes back
+		ShooterPlayer->UpdateRank();
 	}	
 }
 
+void AShooterPlayerState::OverrideWith(class APlayerState* PlayerState)
+{
+	Super::OverrideWith(PlayerState);
+	UpdateRank();
+}
+
 bool AShooterPlayerState::ServerSetColor_Validate(uint8 ColorIndex, FLinearColor NewColor)
 {
 	return ColorIndex < GetNumColors();
@@ -230,6 +260,10 @@ void AShooterPlayerState::ScoreKill(AShooterPlayerState* Victim, int32 Points)
 	ScorePoints(Points);
 	KillsSinceLastDeath++;
 	AShooterGameState* ShooterGameState = GetWorld()->GetGameState<AShooterGameState>();
+	if (ShooterGameState)
+	{
+		ShooterGameState->AddKill(this);
+	}
 	UShooterMessageHandler* MessageHandlerInst = ShooterGameState ? ShooterGameState->GetMessageHandler() : NULL;
 	if (MessageHandlerInst)
 	{
@@ -265,28 +299,16 @@ void AShooterPlayerState::ScorePoints(int32 Points)
 		MyGameState->AddTeamScore(TeamNumber, Points);
 	}
 	SetScore(GetScore() + Points);
+	UpdateRank();
 }
 
 void AShooterPlayerState::InformAboutKill_Implementation(class AShooterPlayerState* KillerPlayerState, class AShooterPlayerState* KilledPlayerState)
 {
-	//id can be null for bots
-	if (KillerPlayerState->GetUniqueId().IsValid())
-	{	
-		//search for the actual killer before calling OnKill()	
-		for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
-		{		
-			AShooterPlayerController* TestPC = Cast<AShooterPlayerController>(It->Get());
-			if (TestPC && TestPC->IsLocalController())
-			{
-				// a local player might not have an ID if it was created with CreateDebugPlayer.
-				ULocalPlayer* LocalPlayer = Cast<ULocalPlayer>(TestPC->Player);
-				FUniqueNetIdRepl LocalID = LocalPlayer->GetCachedUniqueNetId();
-				if (LocalID.IsValid() &&  *LocalPlayer->GetCachedUniqueNetId() == *KillerPlayerState->GetUniqueId())
-				{			
-					TestPC->OnKill();
-				}
-			}
-		}
+	//this only runs on the killer's own connection, where its player state is owned by the killer's controller; bots don't have one
+	AShooterPlayerController* KillerPC = KillerPlayerState ? Cast<AShooterPlayerController>(KillerPlayerState->GetOwner()) : NULL;
+	if (KillerPC && KillerPC->IsLocalController())
+	{
+		KillerPC->OnKill();
 	}
 }
 
@@ -3,10 +3,11 @@
 
 
 #include "Player/ShooterSpectatorPawn.h"
-#include "EngineUtils.h"
+#include "GameRules/ShooterGameState.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "Camera/CameraComponent.h"
 #include "Player/ShooterCharacter.h"
+#include "Player/ShooterPlayerState.h"
 #include "Components/InputComponent.h"
 
 #define MIN_ZOOM 200.f
@@ -18,6 +19,7 @@ AShooterSpectatorPawn::AShooterSpectatorPawn()
 {	
 	bAllowFreeCam = false;
 	bAllowSwitchFocus = false;
+	SpectatedTeamNum = INDEX_NONE;
 
 	// set our turn rates for input
 	BaseTurnRate = 45.f;
@@ -71,38 +73,29 @@ void AShooterSpectatorPawn::SpectateNextCharacter()
 	{
 		return;
 	}
-	bool bFoundCurrentCharacter = false;
-	for (TActorIterator<AShooterCharacter> It(GetWorld()); It; ++It)
+	AShooterGameState* MyGameState = GetWorld()->GetGameState<AShooterGameState>();
+	if (MyGameState)
 	{
-		AShooterCharacter* ShooterCharacter = *It;
-		if (ShooterCharacter && ShooterCharacter->IsAlive())
-		{
-			if (bFoundCurrentCharacter)
-			{
-				SetViewTarget(ShooterCharacter);
-				return;
-			}
-			if (ShooterCharacter == CurrentTarget)
-			{
-				bFoundCurrentCharacter = true;
-			}
-		}
+		//starts from the first character again if CurrentTarget isn't a living character
+		SetViewTarget(MyGameState->GetNextViewableCharacter(CurrentTarget, true, SpectatedTeamNum));
 	}
-	//next character is NULL, set focus to first character again
-	SetViewTarget(GetFirstCharacter());
 }
 
-AShooterCharacter* AShooterSpectatorPawn::GetFirstCharacter() const
+void AShooterSpectatorPawn::SpectateTeam(int32 TeamNum)
 {
-	for (TActorIterator<AShooterCharacter> It(GetWorld()); It; ++It)
+	SpectatedTeamNum = TeamNum;
+	AShooterCharacter* TargetCharacter = Cast<AShooterCharacter>(CurrentTarget);
+	const AShooterPlayerState* TargetPlayerState = TargetCharacter ? TargetCharacter->GetPlayerState<AShooterPlayerState>() : NULL;
+	if (TargetCharacter && TeamNum != INDEX_NONE && (TargetPlayerState == NULL || TargetPlayerState->GetTeamNum() != TeamNum))
 	{
-		AShooterCharacter* ShooterCharacter = *It;
-		if (ShooterCharacter && ShooterCharacter->IsAlive())
-		{
-			return ShooterCharacter;
-		}
+		SetViewTarget(GetFirstCharacter());
 	}
-	return NULL;
+}
+
+AShooterCharacter* AShooterSpectatorPawn::GetFirstCharacter() const
+{
+	AShooterGameState* MyGameState = GetWorld()->GetGameState<AShooterGameState>();
+	return MyGameState ? MyGameState->GetNextViewableCharacter(NULL, true, SpectatedTeamNum) : NULL;
 }
 
 void AShooterSpectatorPawn::SpectatePreviousCharacter()
@@ -111,36 +104,17 @@ void AShooterSpectatorPawn::SpectatePreviousCharacter()
 	{
 		return;
 	}
-	bool bFoundCurrentCharacter = false;
-	AShooterCharacter* PreviousCharacter = GetLastCharacter();
-	for (TActorIterator<AShooterCharacter> It(GetWorld()); It; ++It)
+	AShooterGameState* MyGameState = GetWorld()->GetGameState<AShooterGameState>();
+	if (MyGameState)
 	{
-		AShooterCharacter* ShooterCharacter = *It;
-		if (ShooterCharacter && ShooterCharacter->IsAlive())
-		{
-			if (ShooterCharacter == CurrentTarget)
-			{
-				//found currently spectated character; keep PreviousCharacter and break this loop
-				break;
-			}
-			PreviousCharacter = ShooterCharacter;
-		}
+		SetViewTarget(MyGameState->GetNextViewableCharacter(CurrentTarget, false, SpectatedTeamNum));
 	}
-	SetViewTarget(PreviousCharacter);
 }
 
 AShooterCharacter* AShooterSpectatorPawn::GetLastCharacter() const
 {
-	AShooterCharacter* LastCharacter = NULL;
-	for (TActorIterator<AShooterCharacter> It(GetWorld()); It; ++It)
-	{
-		AShooterCharacter* ShooterCharacter = *It;
-		if (ShooterCharacter && ShooterCharacter->IsAlive())
-		{
-			LastCharacter = ShooterCharacter;
-		}
-	}
-	return LastCharacter;
+	AShooterGameState* MyGameState = GetWorld()->GetGameState<AShooterGameState>();
+	return MyGameState ? MyGameState->GetNextViewableCharacter(NULL, false, SpectatedTeamNum) : NULL;
 }
 
 void AShooterSpectatorPawn::SpectateFreeCamera()
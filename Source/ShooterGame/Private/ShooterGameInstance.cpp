@@ -6,6 +6,8 @@
 #include "GameRules/ShooterGameState.h"
 #include "GameRules/ShooterGameMode.h"
 #include "GameRules/ShooterGameSession.h"
+#include "System/ShooterMapCatalog.h"
+#include "Player/ShooterPersistentUser.h"
 
 UShooterGameInstance::UShooterGameInstance()
 {
@@ -227,40 +229,13 @@ void UShooterGameInstance::StopServerSearch()
 
 void UShooterGameInstance::FillMapList()
 {
-	class FFindMapsVisitor : public IPlatformFile::FDirectoryVisitor
+	MapList.Reset();
+	//the catalog doesn't exist yet when the class default object is constructed
+	UShooterMapCatalog* MapCatalog = UShooterMapCatalog::Get();
+	if (MapCatalog)
 	{
-	public:
-		FFindMapsVisitor() {}
-
-		virtual bool Visit(const TCHAR* FilenameOrDirectory, bool bIsDirectory)
-		{
-			if (!bIsDirectory)
-			{
-				FString FullFilePath(FilenameOrDirectory);
-				if (FPaths::GetExtension(FullFilePath) == TEXT("umap"))
-				{
-					const FString CleanFilename = FPaths::GetBaseFilename(FullFilePath);
-					//only include maps without underscore (e.g. DM-MyMap_Gameplay.umap)
-					if (CleanFilename.Find(TEXT("_")) == INDEX_NONE)
-					{
-						FMapInfo ThisMap;
-						ThisMap.ReadMapData(FullFilePath);
-						if (ThisMap.bSupportsArenaGameModes)
-						{
-							MapsFound.Add(ThisMap);
-						}
-					}
-				}
-			}
-			return true;
-		}
-		TArray<FMapInfo> MapsFound;
-	};
-
-	const FString MapsFolder = FPaths::ProjectContentDir() + TEXT("Maps");
-	FFindMapsVisitor Visitor;
-	FPlatformFileManager::Get().GetPlatformFile().IterateDirectory(*MapsFolder, Visitor);
-	MapList = Visitor.MapsFound;
+		MapCatalog->GetArenaMaps(MapList);
+	}
 }
 
 
@@ -437,6 +412,8 @@ void UShooterGameInstance::OnEndSessionComplete(FName SessionName, bool bWasSucc
 void UShooterGameInstance::Shutdown()
 {
 	EndPlayingState();
+	// write out saves still in flight, including the match results EndPlayingState just recorded
+	UShooterPersistentUser::FlushAllPendingSaves();
 	Super::Shutdown();
 }
 
@@ -0,0 +1,224 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#include "System/ShooterBenchmark.h"
+#include "EngineUtils.h"
+#include "GameFramework/GameMode.h"
+#include "Serialization/JsonSerializer.h"
+#include "AI/ShooterAIController.h"
+#include "Player/ShooterCharacter.h"
+#include "Weapons/ShooterProjectile.h"
+#include "Weapons/ShooterWeapon.h"
+#include "Items/ShooterPickup.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShooterBenchmark, Log, All);
+
+UShooterBenchmark::UShooterBenchmark()
+	: WarmupTicks(300)
+	, MeasuredTicks(3000)
+	, Seed(0)
+	, FixedFPS(30.f)
+	, TickCount(0)
+	, bFinished(false)
+	, LastFrameEnd(0.0)
+	, WorldTickStart(0.0)
+	, PostActorTickStart(0.0)
+	, NumBots(0)
+{
+}
+
+bool UShooterBenchmark::ShouldCreateSubsystem(UObject* Outer) const
+{
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && World->GetNetMode() != NM_Client && FParse::Param(FCommandLine::Get(), TEXT("ShooterBenchmark"));
+}
+
+void UShooterBenchmark::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const TCHAR* CmdLine = FCommandLine::Get();
+	FParse::Value(CmdLine, TEXT("BenchmarkTicks="), MeasuredTicks);
+	FParse::Value(CmdLine, TEXT("BenchmarkWarmupTicks="), WarmupTicks);
+	FParse::Value(CmdLine, TEXT("BenchmarkFPS="), FixedFPS);
+	FParse::Value(CmdLine, TEXT("BenchmarkSeed="), Seed);
+	MeasuredTicks = FMath::Max(MeasuredTicks, 1);
+	WarmupTicks = FMath::Max(WarmupTicks, 0);
+	FixedFPS = FMath::Max(FixedFPS, 1.f);
+
+	if (!FParse::Value(CmdLine, TEXT("BenchmarkReport="), ReportPath))
+	{
+		const TCHAR* Bots = GetWorld()->URL.GetOption(TEXT("Bots="), TEXT("0"));
+		ReportPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / FString::Printf(TEXT("%s_%sbots.json"), *GetWorld()->GetMapName(), Bots);
+	}
+
+	//same simulation every run: fixed time step, no frame rate limiting and seeded random streams
+	FApp::SetBenchmarking(true);
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(1.0 / FixedFPS);
+	FMath::RandInit(Seed);
+	FMath::SRandInit(Seed);
+
+	Samples.Reserve(MeasuredTicks);
+	OnWorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UShooterBenchmark::OnWorldTickStart);
+	OnWorldPostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UShooterBenchmark::OnWorldPostActorTick);
+
+	UE_LOG(LogShooterBenchmark, Log, TEXT("Benchmarking %s: %d warmup ticks, %d measured ticks at %.0f fps, seed %d"), *GetWorld()->GetMapName(), WarmupTicks, MeasuredTicks, FixedFPS, Seed);
+}
+
+void UShooterBenchmark::Deinitialize()
+{
+	FWorldDelegates::OnWorldTickStart.Remove(OnWorldTickStartHandle);
+	FWorldDelegates::OnWorldPostActorTick.Remove(OnWorldPostActorTickHandle);
+	Super::Deinitialize();
+}
+
+void UShooterBenchmark::OnWorldTickStart(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	if (InWorld == GetWorld())
+	{
+		WorldTickStart = FPlatformTime::Seconds();
+	}
+}
+
+void UShooterBenchmark::OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	if (InWorld == GetWorld())
+	{
+		PostActorTickStart = FPlatformTime::Seconds();
+	}
+}
+
+bool UShooterBenchmark::IsTickable() const
+{
+	return !HasAnyFlags(RF_ClassDefaultObject) && !bFinished;
+}
+
+TStatId UShooterBenchmark::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterBenchmark, STATGROUP_Tickables);
+}
+
+UWorld* UShooterBenchmark::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+void UShooterBenchmark::Tick(float DeltaTime)
+{
+	const double Now = FPlatformTime::Seconds();
+	UWorld* World = GetWorld();
+
+	//bots are created when the match is waiting to start and started with it; don't wait for players or warmup
+	AGameMode* GameMode = World->GetAuthGameMode<AGameMode>();
+	if (GameMode && GameMode->GetMatchState() == MatchState::WaitingToStart)
+	{
+		GameMode->StartMatch();
+	}
+
+	if (TickCount == WarmupTicks)
+	{
+		for (TActorIterator<AShooterAIController> It(World); It; ++It)
+		{
+			NumBots++;
+		}
+	}
+	else if (TickCount > WarmupTicks && WorldTickStart > LastFrameEnd && PostActorTickStart >= WorldTickStart)
+	{
+		FFrameSample Sample;
+		Sample.FrameTime = (Now - LastFrameEnd) * 1000.0;
+		Sample.ActorTick = (PostActorTickStart - WorldTickStart) * 1000.0;
+		Sample.PostActorTick = (Now - PostActorTickStart) * 1000.0;
+		Sample.Other = (WorldTickStart - LastFrameEnd) * 1000.0;
+		Samples.Add(Sample);
+	}
+
+	TickCount++;
+	LastFrameEnd = Now;
+
+	if (Samples.Num() >= MeasuredTicks)
+	{
+		bFinished = true;
+		WriteReport();
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+void UShooterBenchmark::WriteReport() const
+{
+	UWorld* World = GetWorld();
+	FArchive* ReportFile = IFileManager::Get().CreateFileWriter(*ReportPath);
+	if (!ReportFile)
+	{
+		UE_LOG(LogShooterBenchmark, Error, TEXT("Couldn't write benchmark report to %s"), *ReportPath);
+		return;
+	}
+
+	auto WritePercentiles = [this](TSharedRef<TJsonWriter<> > JsonWriter, const TCHAR* Name, double FFrameSample::*Member)
+	{
+		TArray<double> Values;
+		Values.Reserve(Samples.Num());
+		double Total = 0.0;
+		for (const FFrameSample& Sample : Samples)
+		{
+			Values.Add(Sample.*Member);
+			Total += Sample.*Member;
+		}
+		Values.Sort();
+		auto Percentile = [&Values](float P) { return Values[FMath::Clamp(FMath::CeilToInt(P * Values.Num()) - 1, 0, Values.Num() - 1)]; };
+
+		JsonWriter->WriteObjectStart(Name);
+		JsonWriter->WriteValue("Mean", Total / Values.Num());
+		JsonWriter->WriteValue("P50", Percentile(0.5f));
+		JsonWriter->WriteValue("P90", Percentile(0.9f));
+		JsonWriter->WriteValue("P95", Percentile(0.95f));
+		JsonWriter->WriteValue("P99", Percentile(0.99f));
+		JsonWriter->WriteValue("Max", Values.Last());
+		JsonWriter->WriteObjectEnd();
+	};
+
+	int32 NumActors = 0, NumCharacters = 0, NumAIControllers = 0, NumWeapons = 0, NumProjectiles = 0, NumPickups = 0;
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		NumActors++;
+		NumCharacters += It->IsA<AShooterCharacter>() ? 1 : 0;
+		NumAIControllers += It->IsA<AShooterAIController>() ? 1 : 0;
+		NumWeapons += It->IsA<AShooterWeapon>() ? 1 : 0;
+		NumProjectiles += It->IsA<AShooterProjectile>() ? 1 : 0;
+		NumPickups += It->IsA<AShooterPickup>() ? 1 : 0;
+	}
+
+	TSharedRef<TJsonWriter<> > JsonWriter = TJsonWriterFactory<>::Create(ReportFile);
+	JsonWriter->WriteObjectStart();
+
+	JsonWriter->WriteValue("Map", World->GetMapName());
+	JsonWriter->WriteValue("GameMode", World->GetAuthGameMode() ? World->GetAuthGameMode()->GetClass()->GetName() : FString());
+	JsonWriter->WriteValue("Bots", NumBots);
+	JsonWriter->WriteValue("Seed", Seed);
+	JsonWriter->WriteValue("FixedFPS", FixedFPS);
+	JsonWriter->WriteValue("WarmupTicks", WarmupTicks);
+	JsonWriter->WriteValue("MeasuredTicks", Samples.Num());
+
+	//game thread timings, in milliseconds
+	JsonWriter->WriteObjectStart("GameThread");
+	WritePercentiles(JsonWriter, TEXT("Frame"), &FFrameSample::FrameTime);
+	WritePercentiles(JsonWriter, TEXT("ActorTick"), &FFrameSample::ActorTick);
+	WritePercentiles(JsonWriter, TEXT("PostActorTick"), &FFrameSample::PostActorTick);
+	WritePercentiles(JsonWriter, TEXT("Other"), &FFrameSample::Other);
+	JsonWriter->WriteObjectEnd();
+
+	//actors alive at the end of the run
+	JsonWriter->WriteObjectStart("Actors");
+	JsonWriter->WriteValue("Total", NumActors);
+	JsonWriter->WriteValue("Characters", NumCharacters);
+	JsonWriter->WriteValue("AIControllers", NumAIControllers);
+	JsonWriter->WriteValue("Weapons", NumWeapons);
+	JsonWriter->WriteValue("Projectiles", NumProjectiles);
+	JsonWriter->WriteValue("Pickups", NumPickups);
+	JsonWriter->WriteObjectEnd();
+
+	JsonWriter->WriteObjectEnd();
+	JsonWriter->Close();
+	delete ReportFile;
+
+	UE_LOG(LogShooterBenchmark, Log, TEXT("Benchmark report written to %s"), *ReportPath);
+}
@@ -0,0 +1,114 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#include "System/ShooterMapCatalog.h"
+#include "HAL/PlatformFilemanager.h"
+
+void UShooterMapCatalog::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Rebuild();
+}
+
+UShooterMapCatalog* UShooterMapCatalog::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UShooterMapCatalog>() : NULL;
+}
+
+void UShooterMapCatalog::Rebuild()
+{
+	class FFindMapsVisitor : public IPlatformFile::FDirectoryVisitor
+	{
+	public:
+		FFindMapsVisitor() {}
+
+		virtual bool Visit(const TCHAR* FilenameOrDirectory, bool bIsDirectory)
+		{
+			if (!bIsDirectory)
+			{
+				FString FullFilePath(FilenameOrDirectory);
+				if (FPaths::GetExtension(FullFilePath) == TEXT("umap"))
+				{
+					MapsFound.Add(FullFilePath);
+				}
+			}
+			return true;
+		}
+		TArray<FString> MapsFound;
+	};
+
+	const FString MapsFolder = FPaths::ProjectContentDir() + TEXT("Maps");
+	FFindMapsVisitor Visitor;
+	FPlatformFileManager::Get().GetPlatformFile().IterateDirectory(*MapsFolder, Visitor);
+
+	Maps.Reset();
+	TeamStreamingLevels.Reset();
+	for (const FString& FullFilePath : Visitor.MapsFound)
+	{
+		const FString CleanFilename = FPaths::GetBaseFilename(FullFilePath);
+		//maps without underscore are base maps, the rest are sublevels (e.g. DM-MyMap_Gameplay.umap)
+		if (CleanFilename.Find(TEXT("_")) == INDEX_NONE)
+		{
+			FMapInfo ThisMap;
+			ThisMap.ReadMapData(FullFilePath);
+			Maps.Add(ThisMap);
+			continue;
+		}
+
+		//team streaming levels are named <BaseMap>_<N>teams, optionally followed by more suffixes
+		int32 SearchStart = 0;
+		int32 TeamsIndex;
+		while ((TeamsIndex = CleanFilename.Find(TEXT("teams"), ESearchCase::IgnoreCase, ESearchDir::FromStart, SearchStart)) != INDEX_NONE)
+		{
+			SearchStart = TeamsIndex + 1;
+			int32 DigitsStart = TeamsIndex;
+			while (DigitsStart > 0 && FChar::IsDigit(CleanFilename[DigitsStart - 1]))
+			{
+				DigitsStart--;
+			}
+			if (DigitsStart == TeamsIndex || DigitsStart == 0 || CleanFilename[DigitsStart - 1] != TEXT('_'))
+			{
+				continue;
+			}
+			FShooterTeamStreamingLevel Level;
+			Level.LevelName = FName(*CleanFilename);
+			Level.NumTeams = FMath::Clamp(FCString::Atoi(*CleanFilename.Mid(DigitsStart, TeamsIndex - DigitsStart)), 0, 255);
+			TeamStreamingLevels.FindOrAdd(CleanFilename.Left(DigitsStart - 1)).Levels.Add(Level);
+			break;
+		}
+	}
+
+	for (TPair<FString, FShooterTeamStreamingLevels>& Pair : TeamStreamingLevels)
+	{
+		Pair.Value.Levels.StableSort([](const FShooterTeamStreamingLevel& A, const FShooterTeamStreamingLevel& B) { return A.NumTeams < B.NumTeams; });
+	}
+}
+
+void UShooterMapCatalog::GetArenaMaps(TArray<FMapInfo>& OutMaps) const
+{
+	for (const FMapInfo& Map : Maps)
+	{
+		if (Map.bSupportsArenaGameModes)
+		{
+			OutMaps.Add(Map);
+		}
+	}
+}
+
+void UShooterMapCatalog::GetTeamStreamingLevels(const FString& MapName, uint8 NumTeams, TArray<FName>& OutLevels) const
+{
+	const FShooterTeamStreamingLevels* Entry = TeamStreamingLevels.Find(MapName);
+	if (Entry)
+	{
+		for (const FShooterTeamStreamingLevel& Level : Entry->Levels)
+		{
+			if (Level.NumTeams > NumTeams)
+			{
+				break;
+			}
+			if (Level.NumTeams > 0)
+			{
+				OutLevels.Add(Level.LevelName);
+			}
+		}
+	}
+}
@@ -0,0 +1,236 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#include "System/ShooterReplicationPolicy.h"
+#include "Player/ShooterCharacter.h"
+#include "Weapons/ShooterWeapon.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetworkObjectList.h"
+#include "Engine/ActorChannel.h"
+#include "Net/NetworkProfiler.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShooterReplication, Log, All);
+
+UShooterReplicationPolicy::UShooterReplicationPolicy()
+	: CharacterTier(100.f, 10.f, 3.f, 15000.f)
+	, EquippedWeaponTier(20.f, 5.f, 3.f, 0.f)
+	, InventoryTier(5.f, 1.f, 1.f, 0.f)
+	, PickupTier(10.f, 1.f, 1.f, 10000.f)
+	, ProjectileTier(30.f, 10.f, 2.f, 15000.f)
+{
+	IdleDelay = 0.5f;
+	ActivePriorityScale = 1.5f;
+	OccludedDistance = 5000.f;
+	OccludedPriorityScale = 0.25f;
+	VisibilityCheckInterval = 0.25f;
+	VisibilityHoldTime = 2.f;
+}
+
+void UShooterReplicationPolicy::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(NetReportHandle);
+	}
+	Super::Deinitialize();
+}
+
+UShooterReplicationPolicy* UShooterReplicationPolicy::Get(UWorld* World)
+{
+	if (World == NULL || !World->IsGameWorld() || World->GetNetMode() == NM_Client || World->GetNetMode() == NM_Standalone)
+	{
+		return NULL;
+	}
+	return World->GetSubsystem<UShooterReplicationPolicy>();
+}
+
+void UShooterReplicationPolicy::ApplyTier(AActor* Actor, const FShooterNetTier& Tier)
+{
+	if (Actor == NULL)
+	{
+		return;
+	}
+	Actor->NetUpdateFrequency = Tier.NetUpdateFrequency;
+	Actor->MinNetUpdateFrequency = FMath::Min(Tier.MinNetUpdateFrequency, Tier.NetUpdateFrequency);
+	Actor->NetPriority = Tier.NetPriority;
+	if (Tier.NetCullDistance > 0.f)
+	{
+		Actor->NetCullDistanceSquared = FMath::Square(Tier.NetCullDistance);
+	}
+}
+
+void UShooterReplicationPolicy::UpdateCharacterRate(AShooterCharacter* Character, FShooterNetActivity& Activity) const
+{
+	const float Now = GetWorld()->GetTimeSeconds();
+	const FRotator AimRotation = Character->GetBaseAimRotation();
+	if (Character->IsFiring() || !Character->GetVelocity().IsNearlyZero(1.f) || Character->WasRecentlyHit() || !AimRotation.Equals(Activity.LastAimRotation, 0.5f))
+	{
+		Activity.LastActiveTime = Now;
+	}
+	Activity.LastAimRotation = AimRotation;
+
+	const bool bActive = Now - Activity.LastActiveTime < IdleDelay;
+	if (bActive == Activity.bActive)
+	{
+		return;
+	}
+	Activity.bActive = bActive;
+
+	AShooterWeapon* Weapon = Character->GetWeapon();
+	if (bActive)
+	{
+		Character->NetUpdateFrequency = CharacterTier.NetUpdateFrequency;
+		Character->NetPriority = CharacterTier.NetPriority * ActivePriorityScale;
+		//don't wait for the idle interval to run out before sending what woke it up
+		Character->ForceNetUpdate();
+		if (Weapon)
+		{
+			Weapon->NetUpdateFrequency = EquippedWeaponTier.NetUpdateFrequency;
+		}
+	}
+	else
+	{
+		Character->NetUpdateFrequency = CharacterTier.MinNetUpdateFrequency;
+		Character->NetPriority = CharacterTier.NetPriority;
+		if (Weapon)
+		{
+			Weapon->NetUpdateFrequency = EquippedWeaponTier.MinNetUpdateFrequency;
+		}
+	}
+}
+
+float UShooterReplicationPolicy::GetOccludedPriorityScale(const AShooterCharacter* Character, FShooterNetActivity& Activity, const AActor* Viewer, const AActor* ViewTarget, const FVector& ViewPos) const
+{
+	if (OccludedDistance <= 0.f || Character->IsFiring())
+	{
+		return 1.f;
+	}
+	const FVector Location = Character->GetActorLocation();
+	if (FVector::DistSquared(ViewPos, Location) < FMath::Square(OccludedDistance))
+	{
+		return 1.f;
+	}
+
+	//only deprioritize enemies for players of this game; spectators, teammates and replay recording always get full priority
+	const APlayerController* ViewerPC = Cast<APlayerController>(Viewer);
+	UWorld* World = GetWorld();
+	if (ViewerPC == NULL || ViewerPC->GetNetConnection() == NULL || ViewerPC->GetNetConnection()->Driver != World->GetNetDriver())
+	{
+		return 1.f;
+	}
+	//checked before IsEnemyFor, which counts viewers without a player state as enemies
+	const APlayerState* ViewerPlayerState = ViewerPC->PlayerState;
+	if (ViewerPlayerState == NULL || ViewerPlayerState->IsSpectator() || ViewerPlayerState->IsOnlyASpectator() || ViewerPC->IsInState(NAME_Spectating)
+		|| !Character->IsEnemyFor(const_cast<APlayerController*>(ViewerPC)))
+	{
+		return 1.f;
+	}
+
+	const float Now = World->GetTimeSeconds();
+	FShooterNetVisibility* Entry = NULL;
+	for (int32 i = Activity.Visibility.Num() - 1; i >= 0; i--)
+	{
+		if (!Activity.Visibility[i].Viewer.IsValid())
+		{
+			Activity.Visibility.RemoveAtSwap(i);
+		}
+		else if (Activity.Visibility[i].Viewer.Get() == Viewer)
+		{
+			Entry = &Activity.Visibility[i];
+		}
+	}
+	if (Entry == NULL)
+	{
+		Entry = &Activity.Visibility[Activity.Visibility.AddDefaulted()];
+		Entry->Viewer = Viewer;
+	}
+
+	if (Now >= Entry->NextCheckTime)
+	{
+		Entry->NextCheckTime = Now + VisibilityCheckInterval;
+
+		FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(ShooterNetVisibility), false, Character);
+		TraceParams.AddIgnoredActor(ViewTarget);
+		if (!World->LineTraceTestByChannel(ViewPos, Location, ECC_Visibility, TraceParams)
+			|| !World->LineTraceTestByChannel(ViewPos, Character->GetPawnViewLocation(), ECC_Visibility, TraceParams))
+		{
+			Entry->LastVisibleTime = Now;
+		}
+	}
+	return (Now - Entry->LastVisibleTime < VisibilityHoldTime) ? 1.f : OccludedPriorityScale;
+}
+
+void UShooterReplicationPolicy::StartNetReport(float Duration)
+{
+	UWorld* World = GetWorld();
+	if (World->GetNetDriver() == NULL || World->GetTimerManager().IsTimerActive(NetReportHandle))
+	{
+		return;
+	}
+#if USE_NETWORK_PROFILER
+	GNetworkProfiler.EnableTracking(true);
+#endif
+	UE_LOG(LogShooterReplication, Log, TEXT("Capturing replication for %.0f seconds"), Duration);
+	World->GetTimerManager().SetTimer(NetReportHandle, this, &UShooterReplicationPolicy::FinishNetReport, FMath::Max(Duration, 1.f), false);
+}
+
+void UShooterReplicationPolicy::FinishNetReport()
+{
+	UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	if (NetDriver == NULL)
+	{
+		return;
+	}
+
+	struct FClassStats
+	{
+		int32 NumActors;
+		int32 NumDormant;
+		int32 NumChannels;
+		float TotalUpdateFrequency;
+
+		FClassStats() : NumActors(0), NumDormant(0), NumChannels(0), TotalUpdateFrequency(0.f) {}
+	};
+	TMap<UClass*, FClassStats> Stats;
+
+	for (const TSharedPtr<FNetworkObjectInfo>& ObjectInfo : NetDriver->GetNetworkObjectList().GetAllObjects())
+	{
+		AActor* Actor = ObjectInfo->Actor;
+		if (Actor)
+		{
+			FClassStats& ClassStats = Stats.FindOrAdd(Actor->GetClass());
+			ClassStats.NumActors++;
+			ClassStats.TotalUpdateFrequency += Actor->NetUpdateFrequency;
+			if (ObjectInfo->DormantConnections.Num() > 0)
+			{
+				ClassStats.NumDormant++;
+			}
+		}
+	}
+	for (UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		for (const auto& ChannelPair : Connection->ActorChannelMap())
+		{
+			if (ChannelPair.Key.IsValid())
+			{
+				Stats.FindOrAdd(ChannelPair.Key->GetClass()).NumChannels++;
+			}
+		}
+	}
+
+	Stats.ValueSort([](const FClassStats& A, const FClassStats& B) { return A.NumChannels > B.NumChannels; });
+	UE_LOG(LogShooterReplication, Log, TEXT("Replication report, %d connections:"), NetDriver->ClientConnections.Num());
+	UE_LOG(LogShooterReplication, Log, TEXT("%-48s %8s %8s %8s %10s"), TEXT("Class"), TEXT("Actors"), TEXT("Dormant"), TEXT("Channels"), TEXT("AvgRate"));
+	for (const auto& StatsPair : Stats)
+	{
+		const FClassStats& ClassStats = StatsPair.Value;
+		UE_LOG(LogShooterReplication, Log, TEXT("%-48s %8d %8d %8d %10.1f"), *StatsPair.Key->GetName(), ClassStats.NumActors, ClassStats.NumDormant, ClassStats.NumChannels,
+			ClassStats.NumActors > 0 ? ClassStats.TotalUpdateFrequency / ClassStats.NumActors : 0.f);
+	}
+
+#if USE_NETWORK_PROFILER
+	//writes the capture to Saved/Profiling; open it in the NetworkProfiler tool for bytes per class
+	GNetworkProfiler.EnableTracking(false);
+	UE_LOG(LogShooterReplication, Log, TEXT("Bytes per class were written to the network profiler capture in %s"), *FPaths::ProfilingDir());
+#endif
+}
@@ -3,6 +3,7 @@
 #include "System/ShooterWorldSettings.h"
 #include "UObject/ConstructorHelpers.h"
 #include "Serialization/JsonSerializer.h"
+#include "System/ShooterMapCatalog.h"
 #if WITH_EDITOR
 #include "Editor.h"
 #endif
@@ -56,5 +57,12 @@ void AShooterWorldSettings::WriteMetaData(uint32 SaveFlags, UWorld* World, bool
 	JsonWriter->WriteObjectEnd();
 	JsonWriter->Close();
 	delete SaveFile;
+
+	//pick up the new metadata (and possibly a new map) in the menus
+	UShooterMapCatalog* MapCatalog = UShooterMapCatalog::Get();
+	if (MapCatalog)
+	{
+		MapCatalog->Rebuild();
+	}
 }
 #endif //WITH_EDITOR
\ No newline at end of file
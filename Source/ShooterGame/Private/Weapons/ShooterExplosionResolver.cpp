@@ -0,0 +1,164 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#include "Weapons/ShooterExplosionResolver.h"
+#include "GameFramework/DamageType.h"
+#include "Components/PrimitiveComponent.h"
+
+const float UShooterExplosionResolver::MaxClusterScale = 2.f;
+
+UShooterExplosionResolver* UShooterExplosionResolver::Get(UWorld* World)
+{
+	if (World == NULL || !World->IsGameWorld() || World->bIsTearingDown)
+	{
+		return NULL;
+	}
+	return World->GetSubsystem<UShooterExplosionResolver>();
+}
+
+void UShooterExplosionResolver::Deinitialize()
+{
+	PendingExplosions.Empty();
+	Super::Deinitialize();
+}
+
+bool UShooterExplosionResolver::IsTickable() const
+{
+	return !HasAnyFlags(RF_ClassDefaultObject) && PendingExplosions.Num() > 0;
+}
+
+TStatId UShooterExplosionResolver::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterExplosionResolver, STATGROUP_Tickables);
+}
+
+UWorld* UShooterExplosionResolver::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+void UShooterExplosionResolver::QueueExplosion(const FVector& Origin, float BaseDamage, float Radius, TSubclassOf<UDamageType> DamageType, AActor* DamageCauser, AController* InstigatedBy)
+{
+	FShooterPendingExplosion& Explosion = PendingExplosions.AddDefaulted_GetRef();
+	Explosion.Origin = Origin;
+	Explosion.BaseDamage = BaseDamage;
+	Explosion.Radius = Radius;
+	Explosion.DamageType = DamageType ? DamageType : TSubclassOf<UDamageType>(UDamageType::StaticClass());
+	Explosion.DamageCauser = DamageCauser;
+	Explosion.InstigatedBy = InstigatedBy;
+}
+
+bool UShooterExplosionResolver::IsDamageableFrom(UPrimitiveComponent* VictimComp, const FVector& Origin, const FCollisionQueryParams& TraceParams, FHitResult& OutHit)
+{
+	const FVector TraceEnd = VictimComp->Bounds.Origin;
+	FVector TraceStart = Origin;
+	if (TraceStart == TraceEnd)
+	{
+		TraceStart.Z += 0.01f;
+	}
+	if (VictimComp->GetWorld()->LineTraceSingleByChannel(OutHit, TraceStart, TraceEnd, ECC_Visibility, TraceParams))
+	{
+		return OutHit.Component == VictimComp;
+	}
+	//nothing in the way: damage the component's center
+	const FVector FakeHitLocation = VictimComp->GetComponentLocation();
+	OutHit = FHitResult(VictimComp->GetOwner(), VictimComp, FakeHitLocation, (Origin - FakeHitLocation).GetSafeNormal());
+	return true;
+}
+
+void UShooterExplosionResolver::Tick(float DeltaTime)
+{
+	//explosions caused by this damage are resolved next frame
+	TArray<FShooterPendingExplosion> Explosions = MoveTemp(PendingExplosions);
+	PendingExplosions.Reset();
+	UWorld* World = GetWorld();
+
+	//group explosions into clusters that share an overlap query; an explosion joins a cluster if its center is within the cluster
+	//sphere and the merged sphere stays within MaxClusterScale times the cluster's biggest explosion, so chains of explosions can't grow it
+	TArray<FSphere, TInlineAllocator<8>> Clusters;
+	TArray<float, TInlineAllocator<8>> ClusterMaxRadii;
+	TArray<int32, TInlineAllocator<8>> ExplosionClusters;
+	ExplosionClusters.SetNumUninitialized(Explosions.Num());
+	for (int32 i = 0; i < Explosions.Num(); i++)
+	{
+		const FSphere ExplosionSphere(Explosions[i].Origin, Explosions[i].Radius);
+		ExplosionClusters[i] = INDEX_NONE;
+		for (int32 ClusterIndex = 0; ClusterIndex < Clusters.Num(); ClusterIndex++)
+		{
+			const FSphere& Cluster = Clusters[ClusterIndex];
+			const float MaxRadius = FMath::Max(ClusterMaxRadii[ClusterIndex], ExplosionSphere.W);
+			if (FVector::DistSquared(Cluster.Center, ExplosionSphere.Center) <= FMath::Square(FMath::Max(Cluster.W, ExplosionSphere.W))
+				&& (Cluster + ExplosionSphere).W <= MaxRadius * MaxClusterScale)
+			{
+				ExplosionClusters[i] = ClusterIndex;
+				Clusters[ClusterIndex] += ExplosionSphere;
+				ClusterMaxRadii[ClusterIndex] = MaxRadius;
+				break;
+			}
+		}
+		if (ExplosionClusters[i] == INDEX_NONE)
+		{
+			ExplosionClusters[i] = Clusters.Add(ExplosionSphere);
+			ClusterMaxRadii.Add(ExplosionSphere.W);
+		}
+	}
+
+	//damage events per explosion and victim, all computed before any damage is dealt
+	TArray<TMap<AActor*, TArray<FHitResult>>> ExplosionVictims;
+	ExplosionVictims.SetNum(Explosions.Num());
+	TArray<FOverlapResult> Overlaps;
+	//damage causers aren't ignored by the shared query, as one explosion's causer may be another's victim
+	const FCollisionQueryParams SphereParams(SCENE_QUERY_STAT(ShooterExplosion), false);
+	for (int32 ClusterIndex = 0; ClusterIndex < Clusters.Num(); ClusterIndex++)
+	{
+		Overlaps.Reset();
+		World->OverlapMultiByObjectType(Overlaps, Clusters[ClusterIndex].Center, FQuat::Identity, FCollisionObjectQueryParams(FCollisionObjectQueryParams::InitType::AllDynamicObjects), FCollisionShape::MakeSphere(Clusters[ClusterIndex].W), SphereParams);
+
+		for (int32 i = 0; i < Explosions.Num(); i++)
+		{
+			if (ExplosionClusters[i] != ClusterIndex)
+			{
+				continue;
+			}
+			const FShooterPendingExplosion& Explosion = Explosions[i];
+			const FCollisionShape ExplosionShape = FCollisionShape::MakeSphere(Explosion.Radius);
+			FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(ShooterExplosionVisibility), true, Explosion.DamageCauser.Get());
+			for (const FOverlapResult& Overlap : Overlaps)
+			{
+				AActor* Victim = Overlap.GetActor();
+				UPrimitiveComponent* VictimComp = Overlap.Component.Get();
+				if (Victim == NULL || !Victim->CanBeDamaged() || Victim == Explosion.DamageCauser.Get() || VictimComp == NULL)
+				{
+					continue;
+				}
+				//the cluster sphere is bigger than this explosion's: test the component's own shape against it, the bounds only reject early
+				if (FMath::SphereAABBIntersection(Explosion.Origin, FMath::Square(Explosion.Radius), VictimComp->Bounds.GetBox())
+					&& VictimComp->OverlapComponent(Explosion.Origin, FQuat::Identity, ExplosionShape))
+				{
+					FHitResult Hit;
+					if (IsDamageableFrom(VictimComp, Explosion.Origin, TraceParams, Hit))
+					{
+						ExplosionVictims[i].FindOrAdd(Victim).Add(Hit);
+					}
+				}
+			}
+		}
+	}
+
+	for (int32 i = 0; i < Explosions.Num(); i++)
+	{
+		const FShooterPendingExplosion& Explosion = Explosions[i];
+		FRadialDamageEvent DamageEvent;
+		DamageEvent.DamageTypeClass = Explosion.DamageType;
+		DamageEvent.Origin = Explosion.Origin;
+		DamageEvent.Params = FRadialDamageParams(Explosion.BaseDamage, 0.f, 0.f, Explosion.Radius, 1.f);
+		for (TPair<AActor*, TArray<FHitResult>>& Victim : ExplosionVictims[i])
+		{
+			//earlier damage may have destroyed it
+			if (!Victim.Key->IsPendingKillPending())
+			{
+				DamageEvent.ComponentHits = MoveTemp(Victim.Value);
+				Victim.Key->TakeDamage(Explosion.BaseDamage, DamageEvent, Explosion.InstigatedBy.Get(), Explosion.DamageCauser.Get());
+			}
+		}
+	}
+}
@@ -0,0 +1,136 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#include "Weapons/ShooterHitValidation.h"
+
+const float FShooterPositionHistory::SampleInterval = 0.05f;
+
+FShooterPositionHistory::FShooterPositionHistory()
+{
+	Reset();
+}
+
+void FShooterPositionHistory::Reset()
+{
+	Newest = INDEX_NONE;
+	NumSamples = 0;
+}
+
+void FShooterPositionHistory::Record(float Time, const FVector& Location)
+{
+	if (NumSamples > 0 && Time - Times[Newest] < SampleInterval)
+	{
+		return;
+	}
+	Newest = (Newest + 1) % MaxSamples;
+	Times[Newest] = Time;
+	Locations[Newest] = Location;
+	NumSamples = FMath::Min(NumSamples + 1, MaxSamples);
+}
+
+FVector FShooterPositionHistory::GetLocationAt(float Time, const FVector& CurrentLocation) const
+{
+	if (NumSamples == 0 || Time >= Times[Newest])
+	{
+		return CurrentLocation;
+	}
+
+	//walk from the newest sample back until we pass Time
+	int32 After = Newest;
+	for (int32 i = 1; i < NumSamples; i++)
+	{
+		const int32 Before = (Newest - i + MaxSamples) % MaxSamples;
+		if (Times[Before] <= Time)
+		{
+			const float Alpha = (Time - Times[Before]) / FMath::Max(Times[After] - Times[Before], KINDA_SMALL_NUMBER);
+			return FMath::Lerp(Locations[Before], Locations[After], Alpha);
+		}
+		After = Before;
+	}
+	return Locations[After];
+}
+
+const float FShooterShotValidator::MinBurstShots = 2.f;
+const float FShooterShotValidator::MaxJitterWindow = 0.5f;
+const float FShooterShotValidator::MaxShotAge = 1.f;
+
+FShooterShotValidator::FShooterShotValidator()
+{
+	Reset();
+}
+
+void FShooterShotValidator::Reset()
+{
+	for (FShot& Shot : RecentShots)
+	{
+		Shot.Time = -MaxShotAge;
+		Shot.HitsLeft = 0;
+		Shot.Sequence = 0;
+		Shot.Seed = 0;
+		Shot.FireMode = 0;
+	}
+	NextShot = 0;
+	ShotCredits = MinBurstShots;
+	LastCreditTime = 0.f;
+}
+
+int32 FShooterShotValidator::FindShot(float Now, uint16 Sequence, uint8 FireMode) const
+{
+	for (int32 i = 0; i < MaxRecentShots; i++)
+	{
+		const FShot& Shot = RecentShots[i];
+		if (Shot.Sequence == Sequence && Shot.FireMode == FireMode && Now - Shot.Time <= MaxShotAge)
+		{
+			return i;
+		}
+	}
+	return INDEX_NONE;
+}
+
+float FShooterShotValidator::GetMaxBurstShots(float TimeBetweenShots, float JitterWindow)
+{
+	if (TimeBetweenShots <= 0.f)
+	{
+		return MinBurstShots;
+	}
+	return FMath::Max(MinBurstShots, 1.f + FMath::Min(JitterWindow, MaxJitterWindow) / TimeBetweenShots);
+}
+
+bool FShooterShotValidator::ConsumeFireCadence(float Now, float TimeBetweenShots, float MaxBurstShots)
+{
+	if (TimeBetweenShots <= 0.f)
+	{
+		//only with MinSemiAutoInterval turned off
+		return true;
+	}
+	ShotCredits = FMath::Min(MaxBurstShots, ShotCredits + (Now - LastCreditTime) / TimeBetweenShots);
+	LastCreditTime = Now;
+	if (ShotCredits < 1.f)
+	{
+		return false;
+	}
+	ShotCredits -= 1.f;
+	return true;
+}
+
+int32 FShooterShotValidator::AddShot(float Now, uint16 Sequence, uint8 Seed, uint8 FireMode, int32 MaxHits)
+{
+	const int32 Index = NextShot;
+	FShot& Shot = RecentShots[Index];
+	Shot.Time = Now;
+	Shot.HitsLeft = MaxHits;
+	Shot.Sequence = Sequence;
+	Shot.Seed = Seed;
+	Shot.FireMode = FireMode;
+	NextShot = (NextShot + 1) % MaxRecentShots;
+	return Index;
+}
+
+bool FShooterShotValidator::ConsumeHit(int32 ShotIndex)
+{
+	if (RecentShots[ShotIndex].HitsLeft <= 0)
+	{
+		return false;
+	}
+	RecentShots[ShotIndex].HitsLeft--;
+	return true;
+}
@@ -4,6 +4,9 @@
 #include "Weapons/ShooterProjectile.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Weapons/ShooterWeapon.h"
+#include "Weapons/ShooterProjectilePool.h"
+#include "Weapons/ShooterExplosionResolver.h"
+#include "System/ShooterReplicationPolicy.h"
 #include "Engine/DirectionalLight.h"
 #include "Kismet/GameplayStatics.h"
 #include "Components/SphereComponent.h"
@@ -60,6 +63,9 @@ AShooterProjectile::AShooterProjectile()
 	DamageType = UShooterDamageType::StaticClass();
 
 	bExplodeOnImpact = true;
+	PoolPrewarmCount = 2;
+	PoolReturnDelay = 3.0f;
+	bInPool = false;
 }
 
 void AShooterProjectile::OnConstruction(const FTransform& Transform)
@@ -81,16 +87,30 @@ void AShooterProjectile::PostInitializeComponents()
 	MovementComp->OnProjectileStop.AddDynamic(this, &AShooterProjectile::OnImpact);
 	MovementComp->OnProjectileBounce.AddDynamic(this, &AShooterProjectile::OnBounce);
 
-	SetLifeSpan( ProjectileLife );
+	if (CanBePooled())
+	{
+		//expired projectiles are recycled instead of destroyed
+		GetWorldTimerManager().SetTimer(ReturnToPoolHandle, this, &AShooterProjectile::ReturnToPool, ProjectileLife, false);
+	}
+	else
+	{
+		SetLifeSpan( ProjectileLife );
+	}
 	MyController = GetInstigatorController();
+
+	UShooterReplicationPolicy* ReplicationPolicy = UShooterReplicationPolicy::Get(GetWorld());
+	if (ReplicationPolicy && GetIsReplicated() && GetLocalRole() == ROLE_Authority)
+	{
+		UShooterReplicationPolicy::ApplyTier(this, ReplicationPolicy->ProjectileTier);
+	}
 }
 
 void AShooterProjectile::InitProjectile(APawn* InInstigator, uint8& InRandomSeed, AShooterWeapon* InOwnerWeapon, FVector& ShootDirection)
 {
-	if (GetInstigator())
-	{
-		MyController = GetInstigator()->GetController();
-	}
+	//the same for freshly spawned and pooled projectiles
+	SetOwner(InOwnerWeapon);
+	AActor::SetInstigator(InInstigator);
+	MyController = InInstigator ? InInstigator->GetController() : NULL;
 	
 	CollisionComp->SetCollisionProfileName(FName("Projectile"));
 	CollisionComp->MoveIgnoreActors.Add(GetInstigator());
@@ -106,6 +126,12 @@ void AShooterProjectile::InitProjectile(APawn* InInstigator, uint8& InRandomSeed
 		//if the server has set to replicate projectiles, AShooterWeapon::FireProjectile won't be called in clients.
 		OwnerWeapon->WeaponPreFireEvent(OwnerWeapon->CurrentFireMode);
 	}
+
+	//freshly spawned projectiles are activated in BeginPlay; pooled ones have begun play already
+	if (HasActorBegunPlay())
+	{
+		ProjectileActivated();
+	}
 }
 
 void AShooterProjectile::StopIgnoringInstigator()
@@ -172,18 +198,20 @@ void AShooterProjectile::Explode(const FHitResult& Impact)
 	const FVector NudgedImpactLocation = Impact.ImpactPoint + Impact.ImpactNormal * 10.0f;
 	if (ExplosionTemplate)
 	{
-		FTransform const SpawnTransform(Impact.ImpactNormal.Rotation(), NudgedImpactLocation);
-		AShooterExplosionEffect* const EffectActor = GetWorld()->SpawnActorDeferred<AShooterExplosionEffect>(ExplosionTemplate, SpawnTransform);
-		if (EffectActor)
-		{
-			EffectActor->SurfaceHit = Impact;
-			UGameplayStatics::FinishSpawningActor(EffectActor, SpawnTransform);
-		}
+		ExplosionTemplate->GetDefaultObject<AShooterExplosionEffect>()->PlayExplosion(GetWorld(), Impact, NudgedImpactLocation, true);
 	}
 
 	if (ExplosionDamage > 0 && ExplosionRadius > 0 && DamageType)
 	{
-		UGameplayStatics::ApplyRadialDamage(this, ExplosionDamage, NudgedImpactLocation, ExplosionRadius, DamageType, TArray<AActor*>(), this, MyController.Get());
+		UShooterExplosionResolver* ExplosionResolver = UShooterExplosionResolver::Get(GetWorld());
+		if (ExplosionResolver)
+		{
+			ExplosionResolver->QueueExplosion(NudgedImpactLocation, ExplosionDamage, ExplosionRadius, DamageType, this, MyController.Get());
+		}
+		else
+		{
+			UGameplayStatics::ApplyRadialDamage(this, ExplosionDamage, NudgedImpactLocation, ExplosionRadius, DamageType, TArray<AActor*>(), this, MyController.Get());
+		}
 	}
 	else if (ExplosionDamage > 0 && DamageType && Impact.GetActor())
 	{
@@ -204,10 +232,130 @@ void AShooterProjectile::DisableAndDestroy()
 	MovementComp->StopMovementImmediately();
 	CollisionComp->SetCollisionProfileName(FName("NoCollision"));
 
+	if (CanBePooled())
+	{
+		GetWorldTimerManager().SetTimer(ReturnToPoolHandle, this, &AShooterProjectile::ReturnToPool, FMath::Max(PoolReturnDelay, 0.01f), false);
+	}
 	//for some reason this causes a crash sometimes, let the projectile live for its ProjectileLife for now
 	//SetLifeSpan(6.0f);
 }
 
+bool AShooterProjectile::CanBePooled() const
+{
+	//replicated projectiles are destroyed as usual; locally spawned ones have authority on clients too
+	return !GetIsReplicated() && GetLocalRole() == ROLE_Authority && !IsPendingKill() && CanClassBePooled(GetClass());
+}
+
+bool AShooterProjectile::CanClassBePooled(UClass* ProjectileClass)
+{
+	return ProjectileClass != NULL
+		&& !ProjectileClass->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(AActor, ReceiveBeginPlay))
+		&& !ProjectileClass->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(AActor, ReceiveTick));
+}
+
+void AShooterProjectile::BeginPlay()
+{
+	Super::BeginPlay();
+	//prewarmed projectiles are activated when they're first fired
+	if (!bInPool)
+	{
+		ProjectileActivated();
+	}
+}
+
+void AShooterProjectile::ReturnToPool()
+{
+	UShooterProjectilePool* Pool = GetWorld() ? GetWorld()->GetSubsystem<UShooterProjectilePool>() : NULL;
+	if (Pool)
+	{
+		Pool->ReleaseProjectile(this);
+	}
+	else
+	{
+		Destroy();
+	}
+}
+
+void AShooterProjectile::DeactivateForPool()
+{
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+	GetWorld()->GetLatentActionManager().RemoveActionsForObject(this);
+	SetLifeSpan(0.f);
+
+	UAudioComponent* ProjAudioComp = FindComponentByClass<UAudioComponent>();
+	if (ProjAudioComp)
+	{
+		ProjAudioComp->Stop();
+	}
+	MovementComp->StopMovementImmediately();
+	MovementComp->Deactivate();
+	CollisionComp->SetCollisionProfileName(FName("NoCollision"));
+	CollisionComp->MoveIgnoreActors.Empty();
+	MainParticleComp->DeactivateSystem();
+	MainParticleComp->KillParticlesForced();
+	TrailParticleComp->DeactivateSystem();
+	TrailParticleComp->KillParticlesForced();
+
+	SetActorHiddenInGame(true);
+	SetActorTickEnabled(false);
+	bInPool = true;
+	ProjectileReset();
+}
+
+void AShooterProjectile::ActivateFromPool(const FTransform& SpawnTM)
+{
+	//weapons and blueprints may have changed these after spawning the previous shot
+	const AShooterProjectile* DefProj = GetClass()->GetDefaultObject<AShooterProjectile>();
+	ExplosionDamage = DefProj->ExplosionDamage;
+	ExplosionRadius = DefProj->ExplosionRadius;
+	DamageType = DefProj->DamageType;
+	ExplosionTemplate = DefProj->ExplosionTemplate;
+	CanBeDeflected = DefProj->CanBeDeflected;
+	ProjectileLife = DefProj->ProjectileLife;
+	bExplodeOnImpact = DefProj->bExplodeOnImpact;
+	CollisionComp->SetSphereRadius(DefProj->CollisionComp->GetUnscaledSphereRadius(), false);
+
+	const UProjectileMovementComponent* DefMovement = DefProj->MovementComp;
+	MovementComp->InitialSpeed = DefMovement->InitialSpeed;
+	MovementComp->MaxSpeed = DefMovement->MaxSpeed;
+	MovementComp->ProjectileGravityScale = DefMovement->ProjectileGravityScale;
+	MovementComp->bRotationFollowsVelocity = DefMovement->bRotationFollowsVelocity;
+	MovementComp->bShouldBounce = DefMovement->bShouldBounce;
+	MovementComp->Bounciness = DefMovement->Bounciness;
+	MovementComp->Friction = DefMovement->Friction;
+	MovementComp->BounceVelocityStopSimulatingThreshold = DefMovement->BounceVelocityStopSimulatingThreshold;
+	MovementComp->bIsHomingProjectile = DefMovement->bIsHomingProjectile;
+	MovementComp->HomingAccelerationMagnitude = DefMovement->HomingAccelerationMagnitude;
+	MovementComp->HomingTargetComponent = NULL;
+
+	//set again by InitProjectile
+	bInPool = false;
+	bExploded = false;
+	RandomSeed = 0;
+	OwnerWeapon = NULL;
+	SetOwner(NULL);
+	AActor::SetInstigator(NULL);
+	MyController = NULL;
+
+	SetActorTransform(SpawnTM, false, nullptr, ETeleportType::ResetPhysics);
+	SetActorHiddenInGame(false);
+	SetActorTickEnabled(true);
+
+	MovementComp->SetUpdatedComponent(CollisionComp);
+	MovementComp->Activate(true);
+	MainParticleComp->SetHiddenInGame(false);
+	MainParticleComp->ActivateSystem(true);
+	TrailParticleComp->ActivateSystem(true);
+
+	UAudioComponent* ProjAudioComp = FindComponentByClass<UAudioComponent>();
+	if (ProjAudioComp && ProjAudioComp->bAutoActivate)
+	{
+		ProjAudioComp->Play();
+	}
+
+	GetWorldTimerManager().SetTimer(ReturnToPoolHandle, this, &AShooterProjectile::ReturnToPool, ProjectileLife, false);
+}
+
 void AShooterProjectile::OnRep_Exploded()
 {
 	//FVector ProjDirection = GetActorRotation().Vector();
@@ -0,0 +1,84 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#include "Weapons/ShooterProjectilePool.h"
+#include "Weapons/ShooterProjectile.h"
+#include "Kismet/GameplayStatics.h"
+
+void UShooterProjectilePool::Deinitialize()
+{
+	Pools.Empty();
+	Super::Deinitialize();
+}
+
+void UShooterProjectilePool::PrewarmProjectiles(TSubclassOf<AShooterProjectile> ProjectileClass, int32 Count)
+{
+	UWorld* World = GetWorld();
+	if (!ProjectileClass || !World || World->bIsTearingDown)
+	{
+		return;
+	}
+	FShooterProjectilePoolEntry& Entry = Pools.FindOrAdd(ProjectileClass);
+	if (!AShooterProjectile::CanClassBePooled(ProjectileClass))
+	{
+		//checked before spawning, so blueprint BeginPlay never runs for a projectile that isn't fired
+		Entry.bPoolable = false;
+		return;
+	}
+	Count = FMath::Min(Count, MaxPooledPerClass);
+	while (Entry.bPoolable && Entry.FreeProjectiles.Num() < Count)
+	{
+		AShooterProjectile* Projectile = World->SpawnActorDeferred<AShooterProjectile>(ProjectileClass, FTransform::Identity, NULL, NULL, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if (!Projectile)
+		{
+			return;
+		}
+		//keeps BeginPlay from activating it at the origin; it's activated when fired
+		Projectile->bInPool = true;
+		UGameplayStatics::FinishSpawningActor(Projectile, FTransform::Identity);
+		if (!Projectile->CanBePooled())
+		{
+			//projectiles of this class replicate in this game; it's destroyed before it ever gets replicated
+			Entry.bPoolable = false;
+			Projectile->Destroy();
+			return;
+		}
+		Projectile->DeactivateForPool();
+		Entry.FreeProjectiles.Add(Projectile);
+	}
+}
+
+AShooterProjectile* UShooterProjectilePool::AcquireProjectile(TSubclassOf<AShooterProjectile> ProjectileClass, const FTransform& SpawnTM)
+{
+	FShooterProjectilePoolEntry* Entry = ProjectileClass ? Pools.Find(ProjectileClass) : NULL;
+	if (!Entry || !Entry->bPoolable)
+	{
+		return NULL;
+	}
+	while (Entry->FreeProjectiles.Num() > 0)
+	{
+		AShooterProjectile* Projectile = Entry->FreeProjectiles.Pop(false);
+		if (Projectile && !Projectile->IsPendingKill())
+		{
+			Projectile->ActivateFromPool(SpawnTM);
+			return Projectile;
+		}
+	}
+	return NULL;
+}
+
+void UShooterProjectilePool::ReleaseProjectile(AShooterProjectile* Projectile)
+{
+	if (!Projectile || Projectile->bInPool)
+	{
+		return;
+	}
+	UWorld* World = GetWorld();
+	FShooterProjectilePoolEntry& Entry = Pools.FindOrAdd(Projectile->GetClass());
+	if (!Projectile->CanBePooled() || !Entry.bPoolable || Entry.FreeProjectiles.Num() >= MaxPooledPerClass || !World || World->bIsTearingDown)
+	{
+		Projectile->Destroy();
+		return;
+	}
+	Projectile->DeactivateForPool();
+	Entry.FreeProjectiles.Add(Projectile);
+}
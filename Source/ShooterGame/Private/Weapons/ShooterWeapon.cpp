@@ -3,8 +3,12 @@
 
 #include "Weapons/ShooterWeapon.h"
 #include "Effects/ShooterImpactEffect.h"
+#include "Effects/ShooterEffectManager.h"
 #include "Weapons/ShooterProjectile.h"
+#include "Weapons/ShooterProjectilePool.h"
+#include "System/ShooterReplicationPolicy.h"
 #include "GameRules/ShooterGameState.h"
+#include "GameRules/ShooterGameMode.h"
 #include "GameFramework/ForceFeedbackEffect.h"
 #include "Camera/CameraShake.h"
 #include "Player/ShooterPlayerController.h"
@@ -15,6 +19,7 @@
 #include "Components/AudioComponent.h"
 #include "AI/ShooterAIController.h"
 #include "Sound/SoundCue.h"
+#include "Async/ParallelFor.h"
 
 DEFINE_LOG_CATEGORY(LogShooterWeapon);
 
@@ -61,7 +66,13 @@ AShooterWeapon::AShooterWeapon()
 	ChargeAmmoTimer = 0.5f;
 	ChargeRandomDisturbance = 0.2f;
 	BurstCounter = 0;
+	ClientShotSequence = 0;
 	bIndependentFireModeCooldown = true;
+	LastBeamTraceTime = 0.f;
+	LastBeamTraceOrigin = FVector::ZeroVector;
+	LastBeamTraceAimDir = FVector::ZeroVector;
+	bBeamHitMovable = false;
+	LastBeamAlpha = 0.f;
 	CharacterAnim = EWeaponAnim::Rifle;
 	SetCanBeDamaged(false);
 	PrimaryActorTick.bCanEverTick = true;
@@ -92,6 +103,12 @@ void AShooterWeapon::PostInitializeComponents()
 			if (DefProj)
 			{
 				InstantConfig[i].ShotThickness = DefProj->GetSimpleCollisionRadius() * 2.f;
+
+				UShooterProjectilePool* ProjectilePool = GetWorld()->GetSubsystem<UShooterProjectilePool>();
+				if (ProjectilePool && GetWorld()->IsGameWorld())
+				{
+					ProjectilePool->PrewarmProjectiles(ProjectileClass[i], DefProj->PoolPrewarmCount);
+				}
 			}
 		}
 	}
@@ -165,6 +182,17 @@ void AShooterWeapon::OnEquip()
 	{
 		PlayWeaponSound(EquipSound);
 	}
+
+	UShooterReplicationPolicy* ReplicationPolicy = UShooterReplicationPolicy::Get(GetWorld());
+	if (ReplicationPolicy && GetLocalRole() == ROLE_Authority)
+	{
+		UShooterReplicationPolicy::ApplyTier(this, ReplicationPolicy->EquippedWeaponTier);
+	}
+	if (GetLocalRole() == ROLE_Authority)
+	{
+		//firing state changes all the time while the weapon is in use
+		SetNetDormancy(DORM_Awake);
+	}
 }
 
 //called on everyone
@@ -220,6 +248,16 @@ void AShooterWeapon::OnUnEquip()
 	}
 	bPendingEquip = false;
 
+	UShooterReplicationPolicy* ReplicationPolicy = UShooterReplicationPolicy::Get(GetWorld());
+	if (ReplicationPolicy && GetLocalRole() == ROLE_Authority)
+	{
+		UShooterReplicationPolicy::ApplyTier(this, ReplicationPolicy->InventoryTier);
+	}
+	if (GetLocalRole() == ROLE_Authority)
+	{
+		SetNetDormancy(DORM_DormantAll);
+	}
+
 	DetermineWeaponState();
 	WeaponUnequippedEvent();
 }
@@ -982,6 +1020,7 @@ void AShooterWeapon::SetOwningPawn(AShooterCharacter* NewOwner)
 		MyPawn = NewOwner;
 		// net owner for RPC calls
 		SetOwner(NewOwner);
+		FlushNetDormancy();
 	}	
 }
 
@@ -1108,6 +1147,7 @@ void AShooterWeapon::StopSimulatingWeaponFire()
 			}
 		}
 		BeamPSC.Empty();
+		BeamSegments.Empty();
 	}
 	StopSimulatingWeaponFireEvent(CurrentFireMode);
 }
@@ -1123,110 +1163,248 @@ void AShooterWeapon::ProcessInstantHit(uint8 RandomSeed)
 	// if Client: notify server of shot; server will replicate effects
 	else if (GetGameState()->bClientSideHitVerification)
 	{
-		ServerNotifyShot(RandomSeed);
+		ClientShotSequence++;
+		ServerNotifyShot(RandomSeed, ClientShotSequence);
 	}
 
-	const float ConeHalfAngle = FMath::DegreesToRadians(GetFiringDispersion() * 0.5f);
-	WeaponRandomStream.Initialize(RandomSeed);
-	
-	FVector AimDir, StartTrace;
-	FHitResult Impact;
-	FVector EndTrace;
 	WeaponPreFireEvent(CurrentFireMode);
+	BuildInstantHitTraces(InstantHitTraces, RandomSeed, true);
+	if (FiringMode[CurrentFireMode] == FM_Beam && InstantHitTraces.Num() > 0)
+	{
+		// the beam FX draws these traces instead of tracing again
+		BeginBeamTrace(InstantHitTraces[0].ShootDir, InstantHitTraces[0].StartTrace);
+	}
 
-	for (uint8 ShotIndex = 0; ShotIndex < ShotsPerTick[CurrentFireMode] && HasEnoughAmmo(); ShotIndex++)
+	// all pellets are traced together, one bounce at a time
+	bool bAnyActive = InstantHitTraces.Num() > 0;
+	while (bAnyActive)
 	{
-		UseAmmo();
-		GetAdjustedAim(AimDir, StartTrace);
-		IncrementMuzzleIndex();
-		const uint8 NumPellets = InstantConfig[CurrentFireMode].BulletsToSpawn;
-		for (uint8 Pellet=0; Pellet < NumPellets; Pellet++)
+		ResolveInstantHitTraces(InstantHitTraces);
+		SetBeamSegments(InstantHitTraces);
+
+		bAnyActive = false;
+		for (FInstantHitTrace& Trace : InstantHitTraces)
 		{
-			// using FVector::ForwardVector in VRandCone and then rotating it in order to get consistent results between clients 
-			// (because AimDir is quantized, VRandCone would give different results)
-			const FVector ShootDirFwd = WeaponRandomStream.VRandCone(FVector::ForwardVector, ConeHalfAngle, ConeHalfAngle);
-			FVector ShootDir = AimDir.Rotation().RotateVector(ShootDirFwd);
-			EndTrace = StartTrace + ShootDir * InstantConfig[CurrentFireMode].WeaponRange;
-			uint8  Bounce = 0;
-			while (Bounce <= InstantConfig[CurrentFireMode].Bounces)
+			if (!Trace.bActive)
 			{
-				if (Bounce == 0)
-				{
-					Impact = WeaponTrace(StartTrace, EndTrace, GetInstigator());
-				}
-				else
-				{
-					Impact = WeaponTrace(StartTrace, EndTrace, this);
-				}
-				if (Impact.bBlockingHit)
-				{
-					WeaponInstantHitEvent(CurrentFireMode, Impact, MyPawn);
-				}
+				continue;
+			}
+			const FHitResult& Impact = Trace.Impact;
+			if (Impact.bBlockingHit)
+			{
+				WeaponInstantHitEvent(CurrentFireMode, Impact, MyPawn);
+			}
 
-				// handle damage
-				if (ShouldDealDamage(Impact.GetActor()))
-				{
-					DealDamage(Impact, ShootDir, Bounce);
-				}
-				else if ( ClientShouldNotifyHit(Impact.GetActor()) )
-				{
-					ServerNotifyInstantHit(Impact, RandomSeed, ShotIndex * NumPellets + Pellet, Bounce);
-				}
+			// handle damage
+			if (ShouldDealDamage(Impact.GetActor()))
+			{
+				DealDamage(Impact, Trace.ShootDir, Trace.Bounce);
+			}
+			else if ( ClientShouldNotifyHit(Impact.GetActor()) )
+			{
+				ServerNotifyInstantHit(Impact, RandomSeed, ClientShotSequence, Trace.PelletIndex, Trace.Bounce);
+			}
 
-				// play FX locally
-				if (GetNetMode() != NM_DedicatedServer)
-				{
-					const FVector EndPoint = Impact.bBlockingHit ? Impact.ImpactPoint : EndTrace;
+			// play FX locally
+			if (GetNetMode() != NM_DedicatedServer)
+			{
+				const FVector EndPoint = Impact.bBlockingHit ? Impact.ImpactPoint : Trace.EndTrace;
 
-					if (FiringMode[CurrentFireMode] != FM_Beam)
+				if (FiringMode[CurrentFireMode] != FM_Beam)
+				{
+					UParticleSystemComponent* TrailPSC = SpawnTrailEffect(Trace.StartTrace, EndPoint, Trace.Bounce == 0 ? Effects[CurrentFireMode].SpawnTrailAttached : false);
+					if (TrailPSC)
 					{
-						UParticleSystemComponent* TrailPSC = SpawnTrailEffect(StartTrace, EndPoint, Bounce == 0? Effects[CurrentFireMode].SpawnTrailAttached : false);
-						if (TrailPSC)
-						{
-							TracerCreatedEvent(TrailPSC, CurrentFireMode, Bounce, StartTrace, EndPoint);
-						}
+						TracerCreatedEvent(TrailPSC, CurrentFireMode, Trace.Bounce, Trace.StartTrace, EndPoint);
 					}
-					SpawnImpactEffects(Impact);
-				}
-				if (InstantConfig[CurrentFireMode].Bounces > 0 && Impact.bBlockingHit && Cast<AShooterCharacter>(Impact.GetActor()) == NULL )
-				{
-					InstantHitBounceEvent(Impact, Bounce+1);
-					FVector Velocity = Impact.ImpactPoint - StartTrace;
-					Velocity.Normalize();
-					ShootDir = -2 * FVector::DotProduct( Velocity, Impact.ImpactNormal )  * Impact.ImpactNormal + Velocity;
-					StartTrace = Impact.ImpactPoint + Impact.ImpactNormal * InstantConfig[CurrentFireMode].ShotThickness;
-					EndTrace = StartTrace + ShootDir * InstantConfig[CurrentFireMode].WeaponRange;
-				}
-				else
-				{
-					Bounce = MAX_uint8 - 1;
 				}
-				Bounce += 1;
+				SpawnImpactEffects(Impact);
 			}
+			AdvanceInstantHitBounce(Trace);
+			bAnyActive |= Trace.bActive;
+		}
+	}
+}
+
+void AShooterWeapon::BuildInstantHitTraces(TArray<FInstantHitTrace>& OutTraces, uint8 RandomSeed, bool bRequireAmmo)
+{
+	OutTraces.Reset();
+
+	const float ConeHalfAngle = FMath::DegreesToRadians(GetFiringDispersion() * 0.5f);
+	WeaponRandomStream.Initialize(RandomSeed);
+
+	const uint8 NumPellets = InstantConfig[CurrentFireMode].BulletsToSpawn;
+	FVector AimDir, StartTrace;
+	for (uint8 ShotIndex = 0; ShotIndex < ShotsPerTick[CurrentFireMode] && (!bRequireAmmo || HasEnoughAmmo()); ShotIndex++)
+	{
+		if (bRequireAmmo)
+		{
+			UseAmmo();
+		}
+		GetAdjustedAim(AimDir, StartTrace);
+		IncrementMuzzleIndex();
+		const FRotator AimRot = AimDir.Rotation();
+		for (uint8 Pellet = 0; Pellet < NumPellets; Pellet++)
+		{
+			FInstantHitTrace& Trace = OutTraces[OutTraces.AddDefaulted()];
+			Trace.PelletIndex = ShotIndex * NumPellets + Pellet;
+			Trace.ShootDir = AimRot.RotateVector(GetPelletDirection(RandomSeed, Trace.PelletIndex, ConeHalfAngle));
+			Trace.StartTrace = StartTrace;
+			Trace.EndTrace = StartTrace + Trace.ShootDir * InstantConfig[CurrentFireMode].WeaponRange;
 		}
 	}
 }
 
-bool AShooterWeapon::ServerNotifyShot_Validate(uint8 RandomSeed)
+FVector AShooterWeapon::GetPelletDirection(uint8 RandomSeed, int32 PelletIndex, float ConeHalfAngle)
+{
+	// using FVector::ForwardVector in VRandCone and then rotating it in order to get consistent results between clients 
+	// (because AimDir is quantized, VRandCone would give different results)
+	FRandomStream PelletStream(int32(HashCombine(RandomSeed, PelletIndex)));
+	return PelletStream.VRandCone(FVector::ForwardVector, ConeHalfAngle, ConeHalfAngle);
+}
+
+void AShooterWeapon::ResolveInstantHitTraces(TArray<FInstantHitTrace>& Traces) const
+{
+	static FName WeaponFireTag = FName(TEXT("WeaponTrace"));
+
+	// query params and shape are the same for every pellet, so set them up only once per batch.
+	// Direct shots ignore the instigator (or the owner, like WeaponTrace), bounced shots only ignore the weapon (so they can hit the owner).
+	APawn* DirectIgnoreActor = GetInstigator() ? GetInstigator() : GetPawnOwner();
+	const FCollisionQueryParams DirectParams(WeaponFireTag, true, DirectIgnoreActor);
+	const FCollisionQueryParams BounceParams(WeaponFireTag, true, this);
+	// the ignore lists are sorted lazily on first use, do that here rather than from several threads at once
+	DirectParams.GetIgnoredComponents();
+	BounceParams.GetIgnoredComponents();
+	const FCollisionShape Shape = FCollisionShape::MakeSphere(InstantConfig[CurrentFireMode].ShotThickness * 0.5f);
+	UWorld* World = GetWorld();
+
+	TArray<int32, TInlineAllocator<32>> ActiveTraces;
+	for (int32 i = 0; i < Traces.Num(); i++)
+	{
+		if (Traces[i].bActive)
+		{
+			ActiveTraces.Add(i);
+		}
+	}
+
+	// scene queries only read the physics scene, so the sweeps of a bounce run on task graph workers together, like async traces do.
+	// Small batches aren't worth handing out.
+	static const int32 MinParallelTraces = 4;
+	ParallelFor(ActiveTraces.Num(), [&](int32 ActiveIndex)
+	{
+		FInstantHitTrace& Trace = Traces[ActiveTraces[ActiveIndex]];
+		Trace.Impact = FHitResult(ForceInit);
+		const bool bHit = World->SweepSingleByChannel(Trace.Impact, Trace.StartTrace, Trace.EndTrace, FQuat::Identity, COLLISION_WEAPON, Shape, Trace.Bounce == 0 ? DirectParams : BounceParams);
+		if (!bHit)
+		{
+			Trace.Impact.Location = Trace.EndTrace;
+			Trace.Impact.ImpactPoint = Trace.EndTrace;
+		}
+	}, ActiveTraces.Num() < MinParallelTraces);
+}
+
+void AShooterWeapon::AdvanceInstantHitBounce(FInstantHitTrace& Trace, bool bNotifyBounce)
+{
+	const FHitResult& Impact = Trace.Impact;
+	if (InstantConfig[CurrentFireMode].Bounces > 0 && Impact.bBlockingHit && Cast<AShooterCharacter>(Impact.GetActor()) == NULL)
+	{
+		if (bNotifyBounce)
+		{
+			InstantHitBounceEvent(Impact, Trace.Bounce + 1);
+		}
+		FVector Velocity = Impact.ImpactPoint - Trace.StartTrace;
+		Velocity.Normalize();
+		Trace.ShootDir = -2 * FVector::DotProduct( Velocity, Impact.ImpactNormal )  * Impact.ImpactNormal + Velocity;
+		Trace.StartTrace = Impact.ImpactPoint + Impact.ImpactNormal * InstantConfig[CurrentFireMode].ShotThickness;
+		Trace.EndTrace = Trace.StartTrace + Trace.ShootDir * InstantConfig[CurrentFireMode].WeaponRange;
+		Trace.Bounce++;
+		Trace.bActive = Trace.Bounce <= InstantConfig[CurrentFireMode].Bounces;
+	}
+	else
+	{
+		Trace.bActive = false;
+	}
+}
+
+bool AShooterWeapon::ServerNotifyShot_Validate(uint8 RandomSeed, uint16 ShotSequence)
 {
 	return GetGameState()->bClientSideHitVerification;
 }
 
-void AShooterWeapon::ServerNotifyShot_Implementation(uint8 RandomSeed)
+void AShooterWeapon::ServerNotifyShot_Implementation(uint8 RandomSeed, uint16 ShotSequence)
 {
+	bool bNewShot;
+	if (ServerAcceptShot(RandomSeed, ShotSequence, bNewShot) == INDEX_NONE || !bNewShot)
+	{
+		return;
+	}
+
+	// play effects on server; a dedicated server has no effects to play, and the hits are verified without tracing again
+	if (GetNetMode() != NM_DedicatedServer)
+	{
+		SimulateInstantHit(HitNotifySeed);
+	}
+}
+
+int32 AShooterWeapon::ServerAcceptShot(uint8 RandomSeed, uint16 ShotSequence, bool& bOutNewShot)
+{
+	const float Now = GetWorld()->GetTimeSeconds();
+	bOutNewShot = false;
+
+	// ServerNotifyShot is unreliable and may arrive after (or instead of) the hits of the same shot
+	const int32 KnownShot = ShotValidator.FindShot(Now, ShotSequence, CurrentFireMode);
+	if (KnownShot != INDEX_NONE)
+	{
+		if (ShotValidator.GetShotSeed(KnownShot) != RandomSeed)
+		{
+			UE_LOG(LogShooterWeapon, Log, TEXT("%s Rejected client side shot (seed doesn't match the shot's)"), *GetNameSafe(this));
+			return INDEX_NONE;
+		}
+		return KnownShot;
+	}
+
+	// *** fire rate test ***
+	// semi-automatic weapons have no fire rate of their own, don't let the client's trigger decide it
+	const AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
+	const float ShotInterval = FMath::Max(TimeBetweenShots[CurrentFireMode], GameMode ? GameMode->MinSemiAutoInterval : 0.f);
+	// shot packets arrive in clumps of up to about the shooter's ping
+	const APlayerState* ShooterPlayerState = MyPawn ? MyPawn->GetPlayerState() : NULL;
+	const float JitterWindow = ShooterPlayerState ? ShooterPlayerState->ExactPing * 0.001f : 0.f;
+	if (!ShotValidator.ConsumeFireCadence(Now, ShotInterval, FShooterShotValidator::GetMaxBurstShots(ShotInterval, JitterWindow)))
+	{
+		UE_LOG(LogShooterWeapon, Log, TEXT("%s Rejected client side shot (faster than the weapon's fire rate)"), *GetNameSafe(this));
+		return INDEX_NONE;
+	}
+
+	// *** ammo test ***
+	if (!HasEnoughAmmo())
+	{
+		UE_LOG(LogShooterWeapon, Log, TEXT("%s Rejected client side shot (not enough ammo)"), *GetNameSafe(this));
+		return INDEX_NONE;
+	}
+
+	// consume ammo the same way the client did in BuildInstantHitTraces
+	int32 NumShots = 0;
+	for (uint8 ShotIndex = 0; ShotIndex < ShotsPerTick[CurrentFireMode] && HasEnoughAmmo(); ShotIndex++)
+	{
+		UseAmmo();
+		NumShots++;
+	}
+
 	// play FX on remote clients
 	HitNotifySeed = RandomSeed;
-	
-	// play effects on server
-	SimulateInstantHit(HitNotifySeed);
+
+	bOutNewShot = true;
+	const int32 MaxHits = NumShots * InstantConfig[CurrentFireMode].BulletsToSpawn * (InstantConfig[CurrentFireMode].Bounces + 1);
+	return ShotValidator.AddShot(Now, ShotSequence, RandomSeed, CurrentFireMode, MaxHits);
 }
 
-bool AShooterWeapon::ServerNotifyInstantHit_Validate(FHitResult Impact, uint8 RandomSeed, uint8 ShotIndex, uint8 BounceNumber)
+bool AShooterWeapon::ServerNotifyInstantHit_Validate(FHitResult Impact, uint8 RandomSeed, uint16 ShotSequence, uint8 ShotIndex, uint8 BounceNumber)
 {
 	return GetGameState()->bClientSideHitVerification;
 }
 
-void AShooterWeapon::ServerNotifyInstantHit_Implementation(FHitResult Impact, uint8 RandomSeed, uint8 ShotIndex, uint8 BounceNumber)
+void AShooterWeapon::ServerNotifyInstantHit_Implementation(FHitResult Impact, uint8 RandomSeed, uint16 ShotSequence, uint8 ShotIndex, uint8 BounceNumber)
 {
 	if (!ShouldDealDamage(Impact.GetActor()))
 	{
@@ -1254,28 +1432,36 @@ void AShooterWeapon::ServerNotifyInstantHit_Implementation(FHitResult Impact, ui
 		return;
 	}
 
-	// *** ammo test ***
-	// @TODO
+	// *** pellet index test ***
+	if (ShotIndex >= ShotsPerTick[CurrentFireMode] * InstantConfig[CurrentFireMode].BulletsToSpawn)
+	{
+		UE_LOG(LogShooterWeapon, Log, TEXT("%s Rejected client side hit of %s (reported pellet doesn't exist in a single shot)"), *GetNameSafe(this), *GetNameSafe(Impact.GetActor()));
+		return;
+	}
 
-	// *** fire rate test ***
-	// @TODO
+	// *** ammo and fire rate test ***
+	bool bNewShot;
+	const int32 Shot = ServerAcceptShot(RandomSeed, ShotSequence, bNewShot);
+	if (Shot == INDEX_NONE)
+	{
+		UE_LOG(LogShooterWeapon, Log, TEXT("%s Rejected client side hit of %s (shot was rejected)"), *GetNameSafe(this), *GetNameSafe(Impact.GetActor()));
+		return;
+	}
 
-	// *** weapon dispersion test ***
-	// @TODO
+	// *** hit count test ***
+	if (!ShotValidator.ConsumeHit(Shot))
+	{
+		UE_LOG(LogShooterWeapon, Log, TEXT("%s Rejected client side hit of %s (more hits than the shot has pellets and bounces)"), *GetNameSafe(this), *GetNameSafe(Impact.GetActor()));
+		return;
+	}
 
-	WeaponRandomStream.Initialize(RandomSeed);
+	// *** weapon dispersion test ***
+	// rebuild the pellet direction from the seed; the view direction test below checks the hit against it
 	const float WeaponAngleDot = FMath::Abs(FMath::Sin(GetFiringDispersion() * PI / 180.f));
 	const float ConeHalfAngle = FMath::DegreesToRadians(GetFiringDispersion() * 0.5f);
 	FVector AimDir, StartTrace;
 	GetAdjustedAim(AimDir, StartTrace);
-
-	FVector ShootDirFwd;
-	for (uint8 i = 0; i <= ShotIndex; i++)
-	{
-		//call this a number of times equal to ShotIndex, to get the same result as the client had
-		ShootDirFwd = WeaponRandomStream.VRandCone(FVector::ForwardVector, ConeHalfAngle, ConeHalfAngle);
-	}
-	FVector ShootDir = AimDir.Rotation().RotateVector(ShootDirFwd);
+	const FVector ShootDir = AimDir.Rotation().RotateVector(GetPelletDirection(RandomSeed, ShotIndex, ConeHalfAngle));
 
 	// assume the client told the truth about static things,
 	// they usually don't have significant gameplay implications
@@ -1322,10 +1508,21 @@ void AShooterWeapon::ServerNotifyInstantHit_Implementation(FHitResult Impact, ui
 	// Get the box center
 	const FVector BoxCenter = (HitBox.Min + HitBox.Max) * 0.5;
 
+	// the client saw characters where they were about a ping ago, so also accept hits on the box moved back there
+	FVector RewoundBoxCenter = BoxCenter;
+	const AShooterCharacter* HitCharacter = Cast<AShooterCharacter>(Impact.GetActor());
+	const APlayerState* ShooterPlayerState = MyPawn ? MyPawn->GetPlayerState() : NULL;
+	if (HitCharacter && ShooterPlayerState)
+	{
+		const float RewindTime = ShooterPlayerState->ExactPing * 0.001f;
+		RewoundBoxCenter += HitCharacter->GetHistoricLocation(GetWorld()->GetTimeSeconds() - RewindTime) - HitCharacter->GetActorLocation();
+	}
+
 	// check that the hit location is within client tolerance
-	if (!(FMath::Abs(Impact.Location.Z - BoxCenter.Z) < BoxExtent.Z &&
-		FMath::Abs(Impact.Location.X - BoxCenter.X) < BoxExtent.X &&
-		FMath::Abs(Impact.Location.Y - BoxCenter.Y) < BoxExtent.Y))
+	const FVector Offset = (Impact.Location - BoxCenter).GetAbs();
+	const FVector RewoundOffset = (Impact.Location - RewoundBoxCenter).GetAbs();
+	if (!(Offset.X < BoxExtent.X && Offset.Y < BoxExtent.Y && Offset.Z < BoxExtent.Z) &&
+		!(RewoundOffset.X < BoxExtent.X && RewoundOffset.Y < BoxExtent.Y && RewoundOffset.Z < BoxExtent.Z))
 	{
 		UE_LOG(LogShooterWeapon, Log, TEXT("%s Rejected client side hit of %s (outside bounding box tolerance)"), *GetNameSafe(this), *GetNameSafe(Impact.GetActor()));
 		return;
@@ -1432,71 +1629,49 @@ void AShooterWeapon::OnRep_ChargingNotify()
 
 void AShooterWeapon::SimulateInstantHit(uint8 RandomSeed)
 {
-	WeaponRandomStream.Initialize(RandomSeed);
-	const float ConeHalfAngle = FMath::DegreesToRadians(GetFiringDispersion()  * 0.5f);
-	
-	FVector AimDir, StartTrace;
-	FHitResult Impact;
-	FVector EndTrace;
-
 	WeaponPreFireEvent(CurrentFireMode);
+	BuildInstantHitTraces(InstantHitTraces, RandomSeed, false);
+	if (FiringMode[CurrentFireMode] == FM_Beam && InstantHitTraces.Num() > 0)
+	{
+		BeginBeamTrace(InstantHitTraces[0].ShootDir, InstantHitTraces[0].StartTrace);
+	}
 
-	for (uint8 ShotIndex = 0; ShotIndex < ShotsPerTick[CurrentFireMode]; ShotIndex++)
+	bool bAnyActive = InstantHitTraces.Num() > 0;
+	while (bAnyActive)
 	{
-		UseAmmo();
-		GetAdjustedAim(AimDir, StartTrace);
-		IncrementMuzzleIndex();
-		for (uint8 Pellet=0; Pellet < InstantConfig[CurrentFireMode].BulletsToSpawn; Pellet++)
+		ResolveInstantHitTraces(InstantHitTraces);
+		SetBeamSegments(InstantHitTraces);
+
+		bAnyActive = false;
+		for (FInstantHitTrace& Trace : InstantHitTraces)
 		{
-			const FVector ShootDirFwd = WeaponRandomStream.VRandCone(FVector::ForwardVector, ConeHalfAngle, ConeHalfAngle);
-			FVector ShootDir = AimDir.Rotation().RotateVector(ShootDirFwd);
-			EndTrace = StartTrace + ShootDir * InstantConfig[CurrentFireMode].WeaponRange;
-			uint8  Bounce = 0;
-			while (Bounce <= InstantConfig[CurrentFireMode].Bounces)
+			if (!Trace.bActive)
 			{
-				if (Bounce == 0)
-				{
-					Impact = WeaponTrace(StartTrace, EndTrace, GetInstigator());
-				}
-				else
-				{
-					Impact = WeaponTrace(StartTrace, EndTrace, this);
-				}
-				const FVector EndPoint = Impact.bBlockingHit ? Impact.ImpactPoint : EndTrace;
-				if (Impact.bBlockingHit)
-				{
-					WeaponInstantHitEvent(CurrentFireMode, Impact, MyPawn);
-					SpawnImpactEffects(Impact);
-				}
-				// deal damage to non-replicated actors (ragdolls, etc)
-				if (Impact.GetActor() && Impact.GetActor()->GetTearOff())
-				{
-					DealDamage(Impact, ShootDir, Bounce);
-				}
+				continue;
+			}
+			const FHitResult& Impact = Trace.Impact;
+			const FVector EndPoint = Impact.bBlockingHit ? Impact.ImpactPoint : Trace.EndTrace;
+			if (Impact.bBlockingHit)
+			{
+				WeaponInstantHitEvent(CurrentFireMode, Impact, MyPawn);
+				SpawnImpactEffects(Impact);
+			}
+			// deal damage to non-replicated actors (ragdolls, etc)
+			if (Impact.GetActor() && Impact.GetActor()->GetTearOff())
+			{
+				DealDamage(Impact, Trace.ShootDir, Trace.Bounce);
+			}
 
-				if (FiringMode[CurrentFireMode] != FM_Beam)
-				{
-					UParticleSystemComponent* TrailPSC = SpawnTrailEffect(StartTrace, EndPoint, Bounce == 0? Effects[CurrentFireMode].SpawnTrailAttached : false);
-					if (TrailPSC)
-					{
-						TracerCreatedEvent(TrailPSC, CurrentFireMode, Bounce, StartTrace, EndPoint);
-					}
-				}
-				if (InstantConfig[CurrentFireMode].Bounces > 0 && Impact.bBlockingHit && Cast<AShooterCharacter>(Impact.GetActor()) == NULL )
-				{
-					InstantHitBounceEvent(Impact, Bounce+1);
-					FVector Velocity = Impact.ImpactPoint - StartTrace;
-					Velocity.Normalize();
-					ShootDir = -2 * FVector::DotProduct( Velocity, Impact.ImpactNormal )  * Impact.ImpactNormal + Velocity;
-					StartTrace = Impact.ImpactPoint + Impact.ImpactNormal * InstantConfig[CurrentFireMode].ShotThickness;
-					EndTrace = StartTrace + ShootDir * InstantConfig[CurrentFireMode].WeaponRange;
-				}
-				else
+			if (FiringMode[CurrentFireMode] != FM_Beam)
+			{
+				UParticleSystemComponent* TrailPSC = SpawnTrailEffect(Trace.StartTrace, EndPoint, Trace.Bounce == 0 ? Effects[CurrentFireMode].SpawnTrailAttached : false);
+				if (TrailPSC)
 				{
-					Bounce = MAX_uint8 - 1;
+					TracerCreatedEvent(TrailPSC, CurrentFireMode, Trace.Bounce, Trace.StartTrace, EndPoint);
 				}
-				Bounce += 1;
 			}
+			AdvanceInstantHitBounce(Trace);
+			bAnyActive |= Trace.bActive;
 		}
 	}
 }
@@ -1518,27 +1693,23 @@ void AShooterWeapon::SpawnImpactEffects(const FHitResult& Impact)
 		}
 
 		FTransform const SpawnTransform(Impact.ImpactNormal.Rotation(), Impact.ImpactPoint);
-		AShooterImpactEffect* EffectActor = GetWorld()->SpawnActorDeferred<AShooterImpactEffect>(Effects[CurrentFireMode].ImpactTemplate, SpawnTransform);
-		if (EffectActor)
-		{
-			EffectActor->SurfaceHit = UseImpact;
-			UGameplayStatics::FinishSpawningActor(EffectActor, SpawnTransform);
-		}
+		Effects[CurrentFireMode].ImpactTemplate->GetDefaultObject<AShooterImpactEffect>()->PlayImpact(GetWorld(), UseImpact, SpawnTransform);
 	}
 }
 
 UParticleSystemComponent* AShooterWeapon::SpawnTrailEffect(const FVector& StartPoint, const FVector& EndPoint, bool SpawnTrailAttached)
 {
 	UParticleSystemComponent* TrailPSC;
-	if (Effects[CurrentFireMode].TrailFX)
+	UShooterEffectManager* EffectManager = UShooterEffectManager::Get(GetWorld());
+	if (Effects[CurrentFireMode].TrailFX && EffectManager)
 	{
 		if (SpawnTrailAttached)
 		{
-			TrailPSC = UGameplayStatics::SpawnEmitterAttached(Effects[CurrentFireMode].TrailFX, GetWeaponMesh(), GetMuzzleName());
+			TrailPSC = EffectManager->SpawnEmitterAttached(Effects[CurrentFireMode].TrailFX, GetWeaponMesh(), GetMuzzleName());
 		}
 		else
 		{
-			TrailPSC = UGameplayStatics::SpawnEmitterAtLocation(this, Effects[CurrentFireMode].TrailFX, StartPoint, (EndPoint - StartPoint).Rotation());
+			TrailPSC = EffectManager->SpawnEmitter(Effects[CurrentFireMode].TrailFX, StartPoint, (EndPoint - StartPoint).Rotation());
 		}
 		if (TrailPSC)
 		{
@@ -1567,6 +1738,7 @@ void AShooterWeapon::FireProjectile(uint8 RandomSeed)
 	FVector AimDir, Origin;
 	
 	const int32 NumProjectiles = ShotsPerTick[CurrentFireMode];
+	UShooterProjectilePool* ProjectilePool = GetWorld()->GetSubsystem<UShooterProjectilePool>();
 	for (int32 i=0; i < NumProjectiles && HasEnoughAmmo(); i++)
 	{
 		UseAmmo();
@@ -1576,11 +1748,20 @@ void AShooterWeapon::FireProjectile(uint8 RandomSeed)
 		IncrementMuzzleIndex();
 
 		FTransform SpawnTM(ShootDir.Rotation(), Origin);
-		AShooterProjectile* Projectile = Cast<AShooterProjectile>(UGameplayStatics::BeginDeferredActorSpawnFromClass(this, ProjectileClass[CurrentFireMode], SpawnTM));
+		//reuse an exploded projectile if there is one, otherwise spawn a new one
+		AShooterProjectile* Projectile = ProjectilePool ? ProjectilePool->AcquireProjectile(ProjectileClass[CurrentFireMode], SpawnTM) : NULL;
+		const bool bFromPool = Projectile != NULL;
+		if (!bFromPool)
+		{
+			Projectile = Cast<AShooterProjectile>(UGameplayStatics::BeginDeferredActorSpawnFromClass(this, ProjectileClass[CurrentFireMode], SpawnTM));
+		}
 		if (Projectile)
 		{
 			Projectile->InitProjectile(GetInstigator(), RandomSeed, this, ShootDir);
-			UGameplayStatics::FinishSpawningActor(Projectile, SpawnTM);
+			if (!bFromPool)
+			{
+				UGameplayStatics::FinishSpawningActor(Projectile, SpawnTM);
+			}
 		}
 	}
 }
@@ -1597,6 +1778,8 @@ void AShooterWeapon::SetFiringMode(uint8 FireModeIndex, EFireMode NewFireMode)
 		return;
 	}
 	FiringMode[FireModeIndex] = NewFireMode;
+	// unequipped weapons are dormant
+	FlushNetDormancy();
 }
 
 USkeletalMeshComponent* AShooterWeapon::GetWeaponMesh() const
@@ -1697,6 +1880,7 @@ float AShooterWeapon::GetFireRate(uint8 FireModeIndex) const
 void AShooterWeapon::SetFireRate(uint8 FireModeIndex, float NewTimeBetweenShots)
 {
 	TimeBetweenShots[FireModeIndex] = NewTimeBetweenShots;
+	FlushNetDormancy();
 }
 
 void AShooterWeapon::SetCrosshair(UTexture2D* NewCrosshair)
@@ -1717,11 +1901,13 @@ bool AShooterWeapon::WantsToFire() const
 void AShooterWeapon::IncrementFiringDispersion(float Increment)
 {
 	CurrentFiringDispersion = FMath::Clamp(CurrentFiringDispersion + Increment, WeaponConfig.BaseFiringDispersion, WeaponConfig.FiringDispersionMax);
+	FlushNetDormancy();
 }
 
 void AShooterWeapon::SetCurrentFiringDispersion(float NewDispersion)
 {
 	CurrentFiringDispersion = FMath::Clamp(NewDispersion, WeaponConfig.BaseFiringDispersion, WeaponConfig.FiringDispersionMax);
+	FlushNetDormancy();
 }
 
 float AShooterWeapon::GetFiringDispersion() const
@@ -1852,69 +2038,152 @@ void AShooterWeapon::UpdateBeam()
 	{
 		return;
 	}
+	const FInstantWeaponData& Config = InstantConfig[CurrentFireMode];
+	const float Now = GetWorld()->GetTimeSeconds();
+	FVector AimDir, Origin;
+	GetAdjustedAim(AimDir, Origin);
+
+	// trace at most every BeamTraceInterval, and only if the beam could have changed since the last trace
+	const bool bAimChanged = FVector::DistSquared(Origin, LastBeamTraceOrigin) > FMath::Square(Config.BeamTraceMinMove) ||
+		FVector::DotProduct(AimDir, LastBeamTraceAimDir) < FMath::Cos(FMath::DegreesToRadians(Config.BeamTraceMinAngle));
+	if (BeamSegments.Num() != BeamPSC.Num() || (Now - LastBeamTraceTime >= Config.BeamTraceInterval && (bAimChanged || bBeamHitMovable)))
+	{
+		TraceBeam(AimDir, Origin);
+	}
+	// the muzzle alternates every update, as it did when every update traced; it's cosmetic, so it doesn't depend on the trace rate
 	for (uint8 ShotIndex = 0; ShotIndex < ShotsPerTick[CurrentFireMode]; ShotIndex++)
 	{
-		FVector ShootDir, StartTrace;
-		FHitResult Impact;
-		FVector EndTrace;
-		GetAdjustedAim(ShootDir, StartTrace);
 		IncrementMuzzleIndex();
-		EndTrace = StartTrace + ShootDir * InstantConfig[CurrentFireMode].WeaponRange;
-		uint8  Bounce, BeamPSCIndex;
-		BeamPSCIndex = (InstantConfig[CurrentFireMode].Bounces+1) * ShotIndex;
-		for (Bounce=0; Bounce <= InstantConfig[CurrentFireMode].Bounces; ++Bounce)
+	}
+
+	const float Alpha = Config.BeamTraceInterval > 0.f ? FMath::Clamp((Now - LastBeamTraceTime) / Config.BeamTraceInterval, 0.f, 1.f) : 1.f;
+	const FVector MuzzleOffset = Origin - LastBeamTraceOrigin;
+	if (Alpha == LastBeamAlpha && MuzzleOffset.IsNearlyZero())
+	{
+		// nothing moved since the FX were last updated
+		return;
+	}
+	LastBeamAlpha = Alpha;
+
+	const int32 SegmentsPerShot = Config.Bounces + 1;
+	for (int32 i = 0; i < BeamPSC.Num(); i++)
+	{
+		UParticleSystemComponent* PSC = BeamPSC[i];
+		if (!PSC)
+		{
+			continue;
+		}
+		const FBeamSegment& Segment = BeamSegments[i];
+		PSC->SetHiddenInGame(!Segment.bVisible);
+		if (Segment.bVisible)
 		{
-			if (BeamPSC[BeamPSCIndex])
+			FVector Start = FMath::Lerp(Segment.FromStart, Segment.Start, Alpha);
+			// keep the first segment of each shot on the muzzle between traces
+			if (i % SegmentsPerShot == 0)
 			{
-				BeamPSC[BeamPSCIndex]->SetHiddenInGame(true);
+				Start += MuzzleOffset;
 			}
-			BeamPSCIndex += 1;
+			PSC->SetVectorParameter(TrailSourceParam, Start);
+			PSC->SetVectorParameter(TrailTargetParam, FMath::Lerp(Segment.FromEnd, Segment.End, Alpha));
 		}
-		Bounce = 0;
-		BeamPSCIndex = (InstantConfig[CurrentFireMode].Bounces+1) * ShotIndex;
-		while (Bounce <= InstantConfig[CurrentFireMode].Bounces)
+	}
+}
+
+void AShooterWeapon::TraceBeam(const FVector& AimDir, const FVector& Origin)
+{
+	const FInstantWeaponData& Config = InstantConfig[CurrentFireMode];
+	InstantHitTraces.Reset();
+	// each shot starts at its own muzzle; UpdateBeam steps the muzzle index itself, so put it back afterwards
+	const uint8 FirstMuzzleIndex = Effects[CurrentFireMode].CurrentMuzzleIndex;
+	for (uint8 ShotIndex = 0; ShotIndex < ShotsPerTick[CurrentFireMode]; ShotIndex++)
+	{
+		FInstantHitTrace& Trace = InstantHitTraces[InstantHitTraces.AddDefaulted()];
+		if (ShotIndex == 0)
+		{
+			Trace.ShootDir = AimDir;
+			Trace.StartTrace = Origin;
+		}
+		else
 		{
-			if (BeamPSC[BeamPSCIndex])
+			GetAdjustedAim(Trace.ShootDir, Trace.StartTrace);
+		}
+		IncrementMuzzleIndex();
+		Trace.EndTrace = Trace.StartTrace + Trace.ShootDir * Config.WeaponRange;
+		Trace.PelletIndex = ShotIndex * Config.BulletsToSpawn;
+	}
+	Effects[CurrentFireMode].CurrentMuzzleIndex = FirstMuzzleIndex;
+
+	BeginBeamTrace(AimDir, Origin);
+	bool bAnyActive = InstantHitTraces.Num() > 0;
+	while (bAnyActive)
+	{
+		ResolveInstantHitTraces(InstantHitTraces);
+		SetBeamSegments(InstantHitTraces);
+
+		bAnyActive = false;
+		for (FInstantHitTrace& Trace : InstantHitTraces)
+		{
+			if (Trace.bActive)
 			{
-				if (Bounce == 0)
-				{
-					Impact = WeaponTrace(StartTrace, EndTrace, GetInstigator(), InstantConfig[CurrentFireMode].WeaponRange);
-				}
-				else
-				{
-					Impact = WeaponTrace(StartTrace, EndTrace, this, InstantConfig[CurrentFireMode].WeaponRange);
-				}
-				BeamPSC[BeamPSCIndex]->SetHiddenInGame(false);
-				BeamPSC[BeamPSCIndex]->SetVectorParameter(TrailSourceParam, StartTrace);
-				if (Impact.bBlockingHit)
-				{
-					BeamPSC[BeamPSCIndex]->SetVectorParameter(TrailTargetParam, Impact.ImpactPoint);
-					//DrawDebugSphere(GetWorld(), Impact.ImpactPoint, 50.f, 7, FColor::Red, false, 1 / 60.f);
-				}
-				else
-				{
-					BeamPSC[BeamPSCIndex]->SetVectorParameter(TrailTargetParam, EndTrace);
-					//DrawDebugSphere(GetWorld(), EndTrace, 50.f, 7, FColor::Red, false, 1 / 60.f);
-				}
-				if (InstantConfig[CurrentFireMode].Bounces > 0 && Impact.bBlockingHit && Cast<AShooterCharacter>(Impact.GetActor()) == NULL )
-				{
-					FVector Velocity = Impact.ImpactPoint - StartTrace;
-					Velocity.Normalize();
-					ShootDir = -2 * FVector::DotProduct( Velocity, Impact.ImpactNormal )  * Impact.ImpactNormal + Velocity;
-					StartTrace = Impact.ImpactPoint + Impact.ImpactNormal * InstantConfig[CurrentFireMode].ShotThickness;
-					EndTrace = StartTrace + ShootDir * InstantConfig[CurrentFireMode].WeaponRange;
-				}
-				else
-				{
-					Bounce = MAX_uint8 - 1;
-				}
+				AdvanceInstantHitBounce(Trace, false);
+				bAnyActive |= Trace.bActive;
 			}
-			Bounce += 1;
-			BeamPSCIndex += 1;
 		}
 	}
 }
 
+void AShooterWeapon::BeginBeamTrace(const FVector& AimDir, const FVector& Origin)
+{
+	if (BeamPSC.Num() == 0)
+	{
+		return;
+	}
+	BeamSegments.SetNum(BeamPSC.Num());
+	for (FBeamSegment& Segment : BeamSegments)
+	{
+		Segment.FromStart = FMath::Lerp(Segment.FromStart, Segment.Start, LastBeamAlpha);
+		Segment.FromEnd = FMath::Lerp(Segment.FromEnd, Segment.End, LastBeamAlpha);
+		Segment.bWasVisible = Segment.bVisible;
+		Segment.bVisible = false;
+	}
+	LastBeamTraceTime = GetWorld()->GetTimeSeconds();
+	LastBeamTraceOrigin = Origin;
+	LastBeamTraceAimDir = AimDir;
+	bBeamHitMovable = false;
+	// force the FX to update on the next UpdateBeam
+	LastBeamAlpha = -1.f;
+}
+
+void AShooterWeapon::SetBeamSegments(const TArray<FInstantHitTrace>& Traces)
+{
+	if (FiringMode[CurrentFireMode] != FM_Beam || BeamSegments.Num() == 0)
+	{
+		return;
+	}
+	const int32 NumPellets = FMath::Max<int32>(InstantConfig[CurrentFireMode].BulletsToSpawn, 1);
+	const int32 SegmentsPerShot = InstantConfig[CurrentFireMode].Bounces + 1;
+	for (const FInstantHitTrace& Trace : Traces)
+	{
+		const int32 Index = (Trace.PelletIndex / NumPellets) * SegmentsPerShot + Trace.Bounce;
+		if (!Trace.bActive || Trace.PelletIndex % NumPellets != 0 || !BeamSegments.IsValidIndex(Index))
+		{
+			continue;
+		}
+		FBeamSegment& Segment = BeamSegments[Index];
+		Segment.Start = Trace.StartTrace;
+		Segment.End = Trace.Impact.bBlockingHit ? Trace.Impact.ImpactPoint : Trace.EndTrace;
+		Segment.bVisible = true;
+		if (!Segment.bWasVisible)
+		{
+			Segment.FromStart = Segment.Start;
+			Segment.FromEnd = Segment.End;
+		}
+
+		const AActor* HitActor = Trace.Impact.GetActor();
+		bBeamHitMovable |= HitActor && !HitActor->IsRootComponentStatic();
+	}
+}
+
 void AShooterWeapon::GetLifetimeReplicatedProps( TArray< FLifetimeProperty > & OutLifetimeProps ) const
 {
 	Super::GetLifetimeReplicatedProps( OutLifetimeProps );
@@ -1954,6 +2223,7 @@ void AShooterWeapon::SetShotsPerTick(uint8 FireMode, uint8 NewShotsPerTick)
 		return;
 	}
 	ShotsPerTick[FireMode] = NewShotsPerTick;
+	FlushNetDormancy();
 }
 
 uint8 AShooterWeapon::GetShotsPerTick(uint8 FireMode) const
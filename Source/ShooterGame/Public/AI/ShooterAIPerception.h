@@ -0,0 +1,111 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#pragma once
+
+#include "ShooterTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ShooterAIPerception.generated.h"
+
+class AShooterAIController;
+class AShooterCharacter;
+
+/** what a bot last knew about one enemy */
+struct FShooterPerceivedEnemy
+{
+	TWeakObjectPtr<AShooterCharacter> Enemy;
+
+	/** the bot had weapon line of sight to the enemy at the last trace */
+	bool bVisible;
+
+	/** a trace was done since the enemy entered the bot's list */
+	bool bTraced;
+
+	FShooterPerceivedEnemy()
+		: bVisible(false)
+		, bTraced(false)
+	{
+	}
+};
+
+/** row of the perception matrix: the enemies of one bot */
+struct FShooterPerceiver
+{
+	TWeakObjectPtr<AShooterAIController> Controller;
+
+	TArray<FShooterPerceivedEnemy> Enemies;
+
+	/** next enemy to trace; 0 once the row is complete */
+	int32 NextEnemy;
+
+	/** world time the last refresh of this row started */
+	float RefreshTime;
+
+	/** the row was completed at least once */
+	bool bHasResults;
+
+	FShooterPerceiver()
+		: NextEnemy(0)
+		, RefreshTime(-BIG_NUMBER)
+		, bHasResults(false)
+	{
+	}
+};
+
+/**
+ *	[server] Shared line of sight cache for bots.
+ *	Keeps, for every bot that asked, which enemies within PerceptionRadius it has weapon line of sight to. Rows are refreshed every
+ *	RefreshInterval, with at most TracesPerTick traces per frame, so the number of LOS traces doesn't depend on how often
+ *	behavior trees ask. Team membership (IShooterControllerInterface::IsEnemyFor) decides which characters are in a row.
+ *	Bots not known yet are added on their first query; until their row is traced, queries report no data and callers trace themselves.
+ */
+UCLASS(config=Game)
+class UShooterAIPerception : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UShooterAIPerception();
+
+	/** returns the perception cache of World, or NULL on clients */
+	static UShooterAIPerception* Get(UWorld* World);
+
+	//Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	//End FTickableGameObject interface
+
+	/** sets OutEnemy to the closest enemy Controller can see, other than ExcludeEnemy, or NULL; returns false if there's no data for Controller yet */
+	bool FindClosestVisibleEnemy(AShooterAIController* Controller, AShooterCharacter* ExcludeEnemy, AShooterCharacter*& OutEnemy);
+
+	/** sets bOutVisible to whether Controller can see Enemy; returns false if Enemy wasn't traced for Controller yet */
+	bool GetLineOfSight(AShooterAIController* Controller, const AActor* Enemy, bool& bOutVisible);
+
+	/** seconds between refreshes of each bot's row */
+	UPROPERTY(config)
+	float RefreshInterval;
+
+	/** max LOS traces per frame for all bots together */
+	UPROPERTY(config)
+	int32 TracesPerTick;
+
+	/** enemies farther than this from a bot are not tracked */
+	UPROPERTY(config)
+	float PerceptionRadius;
+
+protected:
+
+	/** returns the row of Controller, adding it if necessary */
+	FShooterPerceiver& FindOrAddPerceiver(AShooterAIController* Controller);
+
+	/** replaces the enemy list of Perceiver with the enemies currently around its bot, keeping known results */
+	void RebuildEnemies(FShooterPerceiver& Perceiver);
+
+	TArray<FShooterPerceiver> Perceivers;
+
+	/** row the next tick continues with */
+	int32 NextPerceiver;
+};
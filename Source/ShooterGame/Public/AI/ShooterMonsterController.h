@@ -16,9 +16,15 @@ class SHOOTERGAME_API AShooterMonsterController : public AShooterAIController
 public:
 	AShooterMonsterController();
 
+	// Begin AController interface
+	/** gives the controller to UShooterMonsterPool instead of destroying it, if it has room */
+	virtual void PawnPendingDestroy(APawn* InPawn) override;
+	// End AController interface
+
 	// Begin IShooterControllerInterface
 	virtual bool IsEnemyFor(AController* TestPC) const;
 	// End IShooterControllerInterface
-	
-	
+
+	/** [pool] stops the behavior tree and movement and unpossesses the monster */
+	void DeactivateForPool();
 };
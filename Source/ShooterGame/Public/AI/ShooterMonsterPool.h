@@ -0,0 +1,59 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterMonsterPool.generated.h"
+
+class AShooterCharacter;
+class AShooterMonsterController;
+
+/** inactive monsters and controllers of a single monster class */
+USTRUCT()
+struct FShooterMonsterPoolEntry
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** hidden monsters waiting to be reused */
+	UPROPERTY(Transient)
+	TArray<AShooterCharacter*> FreeMonsters;
+
+	/** unpossessed controllers waiting for a monster of this class */
+	UPROPERTY(Transient)
+	TArray<AShooterMonsterController*> FreeControllers;
+};
+
+/**
+ *	[server] Keeps monsters and monster controllers of AShooterGameMode_Invasion around between spawns and waves.
+ *	Controllers of killed monsters are kept instead of being destroyed; killed monsters themselves are torn off and can't be reused,
+ *	but monsters still alive when a wave ends are hidden and kept without going through the death path.
+ */
+UCLASS()
+class UShooterMonsterPool : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	/** returns an inactive monster of MonsterClass moved to Location, or NULL if there is none. It has no controller yet, see PossessMonster. */
+	AShooterCharacter* AcquireMonster(TSubclassOf<AShooterCharacter> MonsterClass, const FVector& Location, const FRotator& Rotation);
+
+	/** possesses Monster with a pooled controller; false if there is none for its class */
+	bool PossessMonster(AShooterCharacter* Monster);
+
+	/** hides a living Monster and keeps it and its controller for reuse; destroys them instead if the pool for its class is full */
+	void ReleaseMonster(AShooterCharacter* Monster);
+
+	/** unpossesses Controller and keeps it for reuse; false if the pool for its monster's class is full */
+	bool ReleaseController(AShooterMonsterController* Controller);
+
+	/** max inactive monsters and controllers kept per class */
+	static const int32 MaxPooledPerClass = 64;
+
+protected:
+
+	UPROPERTY(Transient)
+	TMap<UClass*, FShooterMonsterPoolEntry> Pools;
+};
@@ -0,0 +1,159 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#pragma once
+
+#include "ShooterTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ShooterEffectManager.generated.h"
+
+class UParticleSystem;
+class UParticleSystemComponent;
+class UDecalComponent;
+class UPointLightComponent;
+
+/** inactive particle components of a single template */
+USTRUCT()
+struct FShooterEmitterPool
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(Transient)
+	TArray<UParticleSystemComponent*> FreeComponents;
+};
+
+/** decal currently placed in the world */
+USTRUCT()
+struct FShooterActiveDecal
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(Transient)
+	UDecalComponent* Decal;
+
+	/** world time when the decal is removed */
+	float ExpireTime;
+
+	FShooterActiveDecal()
+		: Decal(NULL)
+		, ExpireTime(0.f)
+	{
+	}
+};
+
+/** explosion light currently fading */
+USTRUCT()
+struct FShooterActiveLight
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(Transient)
+	UPointLightComponent* Light;
+
+	float StartTime;
+
+	float FadeOut;
+
+	/** intensity of the template light */
+	float Intensity;
+
+	FShooterActiveLight()
+		: Light(NULL)
+		, StartTime(0.f)
+		, FadeOut(0.f)
+		, Intensity(0.f)
+	{
+	}
+};
+
+/**
+ *	Plays impact, trail and explosion effects with pooled components instead of spawning effect actors.
+ *	Active emitters, decals and lights each have a budget; when it's full the oldest one (for decals, the first to expire) is recycled.
+ *	Effects are cosmetic and not replicated, so Get() returns NULL on dedicated servers.
+ */
+UCLASS(config=Game)
+class UShooterEffectManager : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UShooterEffectManager();
+
+	/** returns the effect manager of World, or NULL if effects shouldn't play there */
+	static UShooterEffectManager* Get(UWorld* World);
+
+	virtual void Deinitialize() override;
+
+	//Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	//End FTickableGameObject interface
+
+	/** plays Template at Location. The component is returned to the pool when the system finishes. */
+	UParticleSystemComponent* SpawnEmitter(UParticleSystem* Template, const FVector& Location, const FRotator& Rotation);
+
+	/** plays Template attached to AttachTo. The component is detached and returned to the pool when the system finishes. */
+	UParticleSystemComponent* SpawnEmitterAttached(UParticleSystem* Template, USceneComponent* AttachTo, FName AttachPointName);
+
+	/** places a decal on AttachTo for Decal.LifeSpan seconds */
+	UDecalComponent* SpawnDecal(const FDecalData& Decal, UPrimitiveComponent* AttachTo, FName AttachPointName, const FVector& Location, const FRotator& Rotation);
+
+	/** turns on a light with LightTemplate's settings at Location, fading in over FadeOut seconds, then off */
+	void SpawnFadingLight(const UPointLightComponent* LightTemplate, const FVector& Location, float FadeOut);
+
+	/** max emitters playing at once */
+	UPROPERTY(config)
+	int32 MaxActiveEmitters;
+
+	/** max decals in the world at once */
+	UPROPERTY(config)
+	int32 MaxActiveDecals;
+
+	/** max explosion lights at once */
+	UPROPERTY(config)
+	int32 MaxActiveLights;
+
+	/** max inactive particle components kept per template */
+	static const int32 MaxPooledPerTemplate = 16;
+
+protected:
+
+	/** returns an inactive component for Template, creating one if necessary */
+	UParticleSystemComponent* AcquireEmitter(UParticleSystem* Template);
+
+	/** deactivates PSC and returns it to the pool, if it's active */
+	void ReleaseEmitter(UParticleSystemComponent* PSC);
+
+	UFUNCTION()
+	void OnEmitterFinished(UParticleSystemComponent* PSC);
+
+	/** hides Decal and returns it to the pool */
+	void ReleaseDecal(UDecalComponent* Decal);
+
+	/** turns off Light and returns it to the pool */
+	void ReleaseLight(UPointLightComponent* Light);
+
+	UPROPERTY(Transient)
+	TMap<UParticleSystem*, FShooterEmitterPool> EmitterPools;
+
+	/** playing emitters, oldest first */
+	UPROPERTY(Transient)
+	TArray<UParticleSystemComponent*> ActiveEmitters;
+
+	/** placed decals, first to expire first */
+	UPROPERTY(Transient)
+	TArray<FShooterActiveDecal> ActiveDecals;
+
+	UPROPERTY(Transient)
+	TArray<UDecalComponent*> FreeDecals;
+
+	/** fading lights, oldest first */
+	UPROPERTY(Transient)
+	TArray<FShooterActiveLight> ActiveLights;
+
+	UPROPERTY(Transient)
+	TArray<UPointLightComponent*> FreeLights;
+};
@@ -49,6 +49,10 @@ public:
 	/** spawn explosion */
 	virtual void BeginPlay() override;
 
+	/** plays FX, sound, decal and optionally the fading light for Hit with pooled components.
+	  * Projectiles call this on the class default object, so no actor is spawned. */
+	void PlayExplosion(UWorld* World, const FHitResult& Hit, const FVector& LightLocation, bool bWithLight) const;
+
 	/** update fading light */
 	virtual void Tick(float DeltaSeconds) override;
 
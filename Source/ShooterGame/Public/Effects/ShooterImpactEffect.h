@@ -103,6 +103,9 @@ public:
 	/** spawn effect */
 	virtual void PostInitializeComponents() override;
 
+	/** plays FX, sound and decal for Hit with pooled components. Weapons call this on the class default object, so no actor is spawned. */
+	void PlayImpact(UWorld* World, const FHitResult& Hit, const FTransform& SpawnTransform) const;
+
 protected:
 
 	/** get FX for material type */
@@ -10,6 +10,46 @@
 
 DECLARE_LOG_CATEGORY_EXTERN(LogShooterGameMode, Log, All);
 
+/** player start with what it takes to choose it cached, see AShooterGameMode::UpdateSpawnPoints */
+struct FShooterSpawnPoint
+{
+	TWeakObjectPtr<class APlayerStart> Start;
+
+	/** AShooterTeamStart::SpawnTeam, or INDEX_NONE for starts without a team */
+	int32 SpawnTeam;
+
+	bool bAllowPlayers;
+
+	bool bAllowBots;
+
+	/** a character overlapped the start at the last sweep, or somebody was sent there since */
+	bool bOccupied;
+
+	/** living characters within SpawnProximityRadius at the last sweep */
+	TArray<TWeakObjectPtr<class AShooterCharacter>, TInlineAllocator<4>> NearbyCharacters;
+
+	FShooterSpawnPoint()
+		: SpawnTeam(INDEX_NONE)
+		, bAllowPlayers(true)
+		, bAllowBots(true)
+		, bOccupied(false)
+	{
+	}
+};
+
+/** message queued by AShooterGameMode::MessagePlayers until the end of the frame */
+struct FShooterPendingMessage
+{
+	FShooterSentMessage Message;
+
+	/** player the message is relative to, who gets the local text instead of the remote one */
+	TWeakObjectPtr<AController> RelativeTo;
+
+	/** whether the message has a local / remote text, players only get the message if the text they'd see isn't empty */
+	bool bHasLocalText;
+	bool bHasRemoteText;
+};
+
 UCLASS(config=Game)
 class AShooterGameMode : public AGameMode
 {
@@ -28,6 +68,10 @@ public:
 	UFUNCTION(exec)
 	void SetAllowBots(bool bInAllowBots, int32 InMaxBots = 63);
 
+	/** logs replicated actors, channels and update rates per class after Duration seconds, see UShooterReplicationPolicy::StartNetReport */
+	UFUNCTION(exec)
+	void NetReport(float Duration = 10.f);
+
 	virtual void InitGameState() override;
 
 	/** Initialize the game. This is called before actors' PreInitializeComponents. */
@@ -67,6 +111,9 @@ public:
 	/** can players damage each other? */
 	virtual bool CanDealDamage(class AShooterPlayerState* DamageInstigator, class AShooterPlayerState* DamagedPlayer) const;
 
+	/** can players of InstigatorTeam damage players of DamagedTeam? Cached per team pair by AShooterGameState::AreEnemies, so it must only depend on the team numbers. */
+	virtual bool AreTeamsEnemies(uint8 InstigatorTeam, uint8 DamagedTeam) const;
+
 	/** always create cheat manager */
 	virtual bool AllowCheats(APlayerController* P) override;
 	
@@ -117,6 +164,10 @@ public:
 	UPROPERTY(config)
 	bool bClientSideHitVerification;
 
+	/** [server] min seconds between client side shots of weapons without a fire rate (semi-automatic), so a modified client can't fire as fast as it sends shots */
+	UPROPERTY(config)
+	float MinSemiAutoInterval;
+
 	/** True: each projectile fired will be replicated from server to clients. This uses more bandwidth but is very accurate.
 	*	False (recommended): each client will create projectiles on their machines based on whether other players are shooting or not. This uses less bandwidth but is slightly less accurate. */
 	UPROPERTY(config)
@@ -201,13 +252,36 @@ protected:
 	virtual bool IsWinner(class AShooterPlayerState* PlayerState) const;
 
 	/** check if player can use spawnpoint */
-	virtual bool IsSpawnpointAllowed(class APlayerStart* SpawnPoint, AController* Player) const;
+	virtual bool IsSpawnpointAllowed(const FShooterSpawnPoint& SpawnPoint, AController* Player) const;
 
-	/** check if any other player overlaps this spawn point */
-	virtual bool AnyPawnOverlapsSpawnPoint(class APlayerStart* SpawnPoint, AController* Player) const;
-	
 	/** returns the best spawn point from the list, depending on game rules */
-	virtual class APlayerStart* GetBestSpawnPoint(const TArray<class APlayerStart*>& AvailableSpawns, AController* Player) const;
+	virtual FShooterSpawnPoint* GetBestSpawnPoint(const TArray<FShooterSpawnPoint*>& AvailableSpawns, AController* Player) const;
+
+	/** registers the player starts of all loaded levels */
+	void RegisterSpawnPoints();
+
+	/** re-registers the player starts if a level was streamed in or out, and sweeps their occupancy and nearby characters if the last sweep is too old */
+	void UpdateSpawnPoints();
+
+	/** player starts of the loaded levels */
+	TArray<FShooterSpawnPoint> SpawnPoints;
+
+	/** "Play from Here" start in PIE, always used when there is one */
+	TWeakObjectPtr<class APlayerStart> PIEStart;
+
+	/** number of levels in the world when SpawnPoints was built */
+	int32 NumSpawnPointLevels;
+
+	/** world time of the next spawn point sweep */
+	float NextSpawnPointSweepTime;
+
+	/** seconds a spawn point sweep is reused; players spawning in between (e.g. at round start) share it */
+	UPROPERTY(config)
+	float SpawnPointSweepInterval;
+
+	/** characters within this distance of a spawn point are tracked as near it */
+	UPROPERTY(config)
+	float SpawnProximityRadius;
 
 	/** Returns game session class to use */
 	virtual TSubclassOf<AGameSession> GetGameSessionClass() const override;
@@ -253,9 +327,17 @@ public:
 	/** Checks if the player scored an achievement (double kill, killing spree, etc) on his latest kill. Called by the killed ShooterCharacter::Die(). */
 	virtual void CheckAndNotifyAchievements(AController* Killer, AController* KilledPlayer, APawn* KilledPawn, class AActor* DamageCauser);
 
-	/** Calls PC->ClientSendMessage for all player controllers. */
-	void MessagePlayers(TEnumAsByte<EMessageTypes::Type> MessageType, AController* MessageRelativeTo, const FString& InstigatorName = FString(), const FString& InstigatedName = FString(), uint8 OptionalRank = 0, uint8 OptionalTeam = 0) const;
-	void MessagePlayers(TEnumAsByte<EMessageTypes::Type> MessageType, AController* MessageRelativeTo, const APawn* Instigator = NULL, const APawn* Instigated = NULL, uint8 OptionalRank = 0, uint8 OptionalTeam = 0) const;
+	/** Queues a message for all player controllers. Messages are sent next frame, with one PC->ClientSendMessages per player for all the messages queued meanwhile. */
+	void MessagePlayers(TEnumAsByte<EMessageTypes::Type> MessageType, AController* MessageRelativeTo, const FString& InstigatorName = FString(), const FString& InstigatedName = FString(), uint8 OptionalRank = 0, uint8 OptionalTeam = 0);
+	void MessagePlayers(TEnumAsByte<EMessageTypes::Type> MessageType, AController* MessageRelativeTo, const APawn* Instigator = NULL, const APawn* Instigated = NULL, uint8 OptionalRank = 0, uint8 OptionalTeam = 0);
+
+protected:
+
+	/** messages queued by MessagePlayers */
+	TArray<FShooterPendingMessage> PendingMessages;
+
+	/** sends PendingMessages to all player controllers */
+	void FlushPendingMessages();
 };
 
 FORCEINLINE int32 AShooterGameMode::GetWarmupTime()
@@ -28,7 +28,7 @@ public:
 	virtual void Killed(AController* Killer, AController* KilledPlayer, APawn* KilledPawn, TSubclassOf<class AShooterWeapon> KillerWeaponClass, TSubclassOf<class UShooterDamageType> KillerDmgType) override;
 
 	/** try to pick a spawn point that is away from enemies */
-	virtual APlayerStart* GetBestSpawnPoint(const TArray<APlayerStart*>& AvailableSpawns, AController* Player) const;
+	virtual FShooterSpawnPoint* GetBestSpawnPoint(const TArray<FShooterSpawnPoint*>& AvailableSpawns, AController* Player) const;
 
 protected:
 	/** update remaining time */
@@ -90,6 +90,9 @@ public:
 	virtual void InitBot(AShooterAIController* AIC, int32 BotNum) override;	
 	virtual void InitGameState() override;
 	virtual void HandleMatchHasStarted() override;
+	virtual bool ReadyToStartMatch_Implementation() override;
+	/** waits for the waves to load; StartMatch is called from timers and cheats too, not only through ReadyToStartMatch */
+	virtual void StartMatch() override;
 	FORCEINLINE FInvasionWave GetCurrWave() { return Waves[InvasionGameState->CurrentWave]; }
 	
 protected:
@@ -109,5 +112,14 @@ protected:
 	/** retrieved by the server from its PersistentUser */
 	TArray<FInvasionWave> Waves;
 
+	/** false until the PersistentUser holding Waves has been loaded; the match doesn't start before that */
+	bool bWavesLoaded;
+
+	/** StartMatch was called before the waves were loaded; OnWavesLoaded starts the match */
+	bool bStartMatchWhenLoaded;
+
+	/** called when the async load started in InitGame is done */
+	void OnWavesLoaded(class UShooterPersistentUser* PersistentUser);
+
 	FTimerHandle SpawnMonsterHandle;
 };
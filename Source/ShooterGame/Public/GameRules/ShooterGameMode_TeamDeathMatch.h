@@ -27,6 +27,9 @@ public:
 	/** can players damage each other? */
 	virtual bool CanDealDamage(class AShooterPlayerState* DamageInstigator, class AShooterPlayerState* DamagedPlayer) const override;
 
+	/** players can only damage the other teams */
+	virtual bool AreTeamsEnemies(uint8 InstigatorTeam, uint8 DamagedTeam) const override;
+
 	/** called when a player changes teams, attempts to rebalance teams by sending bots to other teams */
 	virtual void PlayerChangedToTeam(AShooterPlayerState* Player, uint8 NewTeam);
 
@@ -50,7 +53,7 @@ protected:
 	virtual bool IsWinner(class AShooterPlayerState* PlayerState) const override;
 
 	/** check team constraints */
-	virtual bool IsSpawnpointAllowed(APlayerStart* SpawnPoint, AController* Player) const;
+	virtual bool IsSpawnpointAllowed(const FShooterSpawnPoint& SpawnPoint, AController* Player) const;
 
 	/** initialization for bot after spawning */
 	virtual void InitBot(AShooterAIController* AIC, int32 BotNum) override;	
@@ -9,6 +9,38 @@
 
 DECLARE_LOG_CATEGORY_EXTERN(LogShooterGameState, Log, All);
 
+/** players of one team, ranked by score (first rank = index 0) */
+USTRUCT()
+struct FShooterRankedTeam
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(Transient)
+	TArray<class AShooterPlayerState*> Players;
+
+	/** truncated score each player was ranked with, descending */
+	TArray<int32> Scores;
+};
+
+/** neighbors of a character in the spectator cycle */
+USTRUCT()
+struct FShooterViewableLink
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(Transient)
+	class AShooterCharacter* Prev;
+
+	UPROPERTY(Transient)
+	class AShooterCharacter* Next;
+
+	FShooterViewableLink()
+		: Prev(NULL)
+		, Next(NULL)
+	{
+	}
+};
+
 UCLASS(config = Game)
 class AShooterGameState : public AGameState
 {
@@ -58,10 +90,22 @@ protected:
 	UPROPERTY(BlueprintReadOnly, Category=GameState, Transient, Replicated)
 	uint8 NumTeams;
 
-	/** allocates TeamScores, according to the number of teams */
+	/** kills every player got this match, kept up to date by AddKill; replicated so GetTotalKills works on clients as well */
+	UPROPERTY(Transient, Replicated)
+	int32 TotalKills;
+
+	/** [server] kills per team, kept up to date by AddKill */
+	UPROPERTY(Transient)
+	TArray<int32> TeamKills;
+
+	/** allocates TeamScores and TeamKills, according to the number of teams */
 	void InitTeamScores();
 
 	// Begin AActor interface
+	/** also clears the kill counts */
+	virtual void Reset() override;
+
+	/** also adds characters that started playing before this game state, e.g. on clients joining in progress */
 	virtual void PostInitializeComponents() override;
 	// End AActor interface
 	
@@ -79,6 +123,38 @@ protected:
 	virtual void ReceivedGameModeClass() override;
 	//End AGameState interface
 
+	/** ranked players, indexed by team number. Kept sorted by UpdatePlayerRank, so queries don't need to sort. */
+	UPROPERTY(Transient)
+	TArray<FShooterRankedTeam> RankedTeams;
+
+	/** removes Player from RankedTeams */
+	void RemovePlayerRank(class AShooterPlayerState* Player);
+
+	/** living characters in spectator cycle order, as a ring */
+	UPROPERTY(Transient)
+	TMap<class AShooterCharacter*, FShooterViewableLink> ViewableCharacters;
+
+	/** first character of the cycle, NULL if there is none */
+	UPROPERTY(Transient)
+	class AShooterCharacter* FirstViewableCharacter;
+
+	/** true if Character is alive and belongs to TeamNum, or TeamNum is INDEX_NONE */
+	static bool IsViewableCharacterInTeam(const class AShooterCharacter* Character, int32 TeamNum);
+
+	/** game mode CDO the team relations were built from; kept alive by GameModeClass */
+	mutable const class AShooterGameMode* TeamRelationsGame;
+
+	/** GameModeClass and NumTeams the team relations were built for; they're rebuilt when either changes */
+	mutable UClass* TeamRelationsGameModeClass;
+	mutable int32 TeamRelationsNumTeams;
+
+	/** AreTeamsEnemies of TeamRelationsGame for every team pair, indexed by InstigatorTeam * TeamRelationsSize + DamagedTeam */
+	mutable TArray<bool> TeamRelations;
+	mutable int32 TeamRelationsSize;
+
+	/** rebuilds TeamRelations from the current game mode class and number of teams */
+	void UpdateTeamRelations() const;
+
 public:
 
 	UFUNCTION(BlueprintPure, Category = GameState)
@@ -98,7 +174,14 @@ public:
 
 	/** returns the total number of kills that every player got this match (doesn't counts suicides) */
 	UFUNCTION(BlueprintCallable, Category=GameState)
-	int32 GetTotalKills();
+	int32 GetTotalKills() const;
+
+	/** [server] returns the number of kills the players of TeamNum got this match */
+	UFUNCTION(BlueprintPure, Category=GameState)
+	int32 GetTeamKills(uint8 TeamNum) const;
+
+	/** [server] counts a kill by Killer. Called by AShooterPlayerState::ScoreKill. */
+	void AddKill(class AShooterPlayerState* Killer);
 
 	/** returns whether this is a team game */
 	UFUNCTION(BlueprintPure, Category = GameState)
@@ -127,6 +210,30 @@ public:
 	/** gets ranked PlayerState map for specific team (first rank = position 0) */
 	UFUNCTION(BlueprintPure, Category = GameState)
 	TArray<class AShooterPlayerState*> GetRankedPlayerArray(int32 TeamIndex) const;
+
+	/** same as GetRankedPlayerArray, without copying the array */
+	const TArray<class AShooterPlayerState*>& GetRankedPlayers(int32 TeamIndex) const;
+
+	/** re-ranks Player after its score or team changed. Called by AShooterPlayerState on server and clients. */
+	void UpdatePlayerRank(class AShooterPlayerState* Player);
+
+	/** adds Character to the end of the spectator cycle. Called by AShooterCharacter on server and clients when it starts playing. */
+	void AddViewableCharacter(class AShooterCharacter* Character);
+
+	/** removes Character from the spectator cycle. Called by AShooterCharacter when it dies or leaves play; safe to call if it was never added. */
+	void RemoveViewableCharacter(class AShooterCharacter* Character);
+
+	/** 
+	 * Returns the character after Current in the spectator cycle (before it, if !bForward) that belongs to TeamNum, or NULL if there is none.
+	 * If Current isn't in the cycle, returns the first (last, if !bForward) one. TeamNum INDEX_NONE accepts any character.
+	 */
+	class AShooterCharacter* GetNextViewableCharacter(const AActor* Current, bool bForward = true, int32 TeamNum = INDEX_NONE) const;
+
+	/**
+	 * Returns true if TestPlayer is an enemy of MyPlayer, i.e. the game mode lets TestPlayer damage MyPlayer.
+	 * Players without a player state (monsters) are everyone's enemy. Works on clients, using the replicated game mode class.
+	 */
+	bool AreEnemies(class AShooterPlayerState* TestPlayer, class AShooterPlayerState* MyPlayer) const;
 	
 	void RequestFinishAndExitToMainMenu();
 };
@@ -0,0 +1,110 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#pragma once
+
+#include "ShooterTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "WorldCollision.h"
+#include "ShooterSpawnCandidatePool.generated.h"
+
+class AShooterCharacter;
+
+/** navmesh point monsters can be spawned at */
+struct FShooterSpawnCandidate
+{
+	FVector Location;
+
+	/** bumped whenever the candidate is replaced, so traces issued for the old point are ignored */
+	uint16 Generation;
+
+	/** visibility traces still in flight */
+	int32 PendingTraces;
+
+	/** a player saw the point in the traces in flight */
+	bool bSeenInCheck;
+
+	/** a player could see the point at the last completed check */
+	bool bVisible;
+
+	/** at least one check has completed since the point was sampled */
+	bool bValidated;
+
+	FShooterSpawnCandidate()
+		: Location(ForceInit)
+		, Generation(0)
+		, PendingTraces(0)
+		, bSeenInCheck(false)
+		, bVisible(false)
+		, bValidated(false)
+	{
+	}
+};
+
+/**
+ *	Keeps a pool of random navmesh points and checks in the background whether players can see them, so that AShooterGameMode_Invasion
+ *	can spawn a monster out of sight without sampling the navmesh and tracing from every player on the spot.
+ *	Candidates are sampled and re-checked a few per tick, with async traces whose results arrive on a later frame.
+ *	Does nothing until Activate() is called.
+ */
+UCLASS(config=Game)
+class UShooterSpawnCandidatePool : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UShooterSpawnCandidatePool();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	//Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	//End FTickableGameObject interface
+
+	/** starts filling and checking the pool */
+	void Activate();
+
+	/** stops maintaining the pool and forgets all candidates */
+	void Deactivate();
+
+	/** returns a checked point no player could see and that doesn't overlap anybody, or one players can see if there is none. The point is replaced by a new one afterwards. */
+	bool PickSpawnLocation(AShooterCharacter* TestCharacter, FVector& OutLocation);
+
+	/** number of candidates kept */
+	UPROPERTY(config)
+	int32 PoolSize;
+
+	/** new navmesh points sampled per tick while the pool isn't full */
+	UPROPERTY(config)
+	int32 SamplesPerTick;
+
+	/** candidates re-checked per tick */
+	UPROPERTY(config)
+	int32 ChecksPerTick;
+
+protected:
+
+	/** replaces the candidate at Index with a new random navmesh point; false if there's no navmesh */
+	bool SampleCandidate(int32 Index);
+
+	/** issues a visibility trace from every living player to the candidate at Index */
+	void CheckCandidate(int32 Index, const TArray<FVector>& ViewPoints);
+
+	void OnVisibilityTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	TArray<FShooterSpawnCandidate> Candidates;
+
+	/** next candidate to re-check */
+	int32 NextCheckIndex;
+
+	bool bActive;
+
+	/** generation given to the next sampled candidate */
+	uint16 NextGeneration;
+
+	FTraceDelegate VisibilityTraceDelegate;
+};
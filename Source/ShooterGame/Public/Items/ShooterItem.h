@@ -17,6 +17,9 @@ class AShooterItem : public AActor
 public:
 	AShooterItem();
 
+	/** [server] applies the inventory replication tier */
+	virtual void PostInitializeComponents() override;
+
 	void SetOwningPawn(class AShooterCharacter* NewOwner);
 
 	/** item enters MyPawn's inventory. Called automatically when MyPawn changes. */
@@ -21,6 +21,9 @@ public:
 
 	virtual void PostInitializeComponents() override;
 
+	/** stops the idle animation */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	/** pickup on touch */
 	virtual void NotifyActorBeginOverlap(class AActor* Other) override;
 
@@ -62,6 +65,21 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category = Pickup)
 	void GetPickupMessage(FText& Text, class UTexture2D*& LeftImage, class UTexture2D*& RightImage) const;
 
+	/** how far the mesh bobs up and down while the pickup is at rest; animated by UShooterPickupManager */
+	UPROPERTY(EditDefaultsOnly, Category=Effects)
+	float BobHeight;
+
+	/** bob cycles per second */
+	UPROPERTY(EditDefaultsOnly, Category=Effects)
+	float BobRate;
+
+	/** degrees per second the mesh spins around while the pickup is at rest */
+	UPROPERTY(EditDefaultsOnly, Category=Effects)
+	float SpinRate;
+
+	USkeletalMeshComponent* GetPickupMesh() const { return PickupMeshComp; }
+	class UParticleSystemComponent* GetPickupPSC() const { return PickupPSC; }
+
 protected:
 	
 	UPROPERTY(VisibleDefaultsOnly, BlueprintReadOnly, Category=Collision)
@@ -101,10 +119,13 @@ protected:
 	/** returns true if TestPawn already picked up this powerup. */
 	bool PawnAlreadyPickedUp(class AShooterCharacter* TestPawn);
 
-	/** characters that picked up this powerup. Only filled if PickupStay == true. */
-	TArray<class AShooterCharacter*> Pickers;
+	/** characters that picked up this powerup, with the life (AShooterCharacter::GetLifeId) they picked it up in. Only filled if PickupStay == true. */
+	TMap<TWeakObjectPtr<class AShooterCharacter>, int32> Pickers;
 
-	/** removes characters that are dead or no longer exist from Pickers array */
+	/** size of Pickers after the last cleanup; it's only swept again once it has doubled */
+	int32 NumPickersAfterCleanup;
+
+	/** removes Pickers entries of characters that no longer exist, are dead or have since been reused from the monster pool */
 	void CleanupPickers();
 
 	/* The character who has picked up this pickup */
@@ -114,6 +135,13 @@ protected:
 	UFUNCTION()
 	void OnRep_IsActive();
 
+	/** movement came to rest: turns it off until the pickup gets a new velocity */
+	UFUNCTION()
+	void OnMovementStopped(const FHitResult& ImpactResult);
+
+	/** registers the pickup with UShooterPickupManager while it's shown and at rest, unregisters it otherwise; the manager then ticks the mesh */
+	void UpdateIdleAnimation();
+
 	/** what this pickup does (restore health, give ammo, etc...) */
 	virtual void GivePickupTo(class AShooterCharacter* Pawn);
 	
@@ -159,5 +187,4 @@ protected:
 	float GetRespawnTime() const;
 
 	FTimerHandle RespawnPickupHandle;
-	FTimerHandle CleanupPickersHandle;
 };
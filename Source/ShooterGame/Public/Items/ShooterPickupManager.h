@@ -0,0 +1,71 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#pragma once
+
+#include "ShooterTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ShooterPickupManager.generated.h"
+
+class AShooterPickup;
+
+/** pickup resting in place, whose mesh and effects are updated by UShooterPickupManager */
+USTRUCT()
+struct FShooterIdlePickup
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(Transient)
+	AShooterPickup* Pickup;
+
+	/** mesh location and rotation relative to its parent when the pickup came to rest */
+	FVector BaseLocation;
+	FRotator BaseRotation;
+
+	/** offset into the bob cycle, so neighbouring pickups don't move in lockstep */
+	float Phase;
+
+	FShooterIdlePickup()
+		: Pickup(NULL)
+		, BaseLocation(ForceInit)
+		, BaseRotation(ForceInit)
+		, Phase(0.f)
+	{
+	}
+};
+
+/**
+ *	Updates all resting pickups from a single tick, so that pickups and their meshes don't need to tick while they sit in place.
+ *	Pickups that were rendered recently get their mesh animation, bob and spin updated; the particle effects of the others are paused.
+ *	The animation is cosmetic, so Get() returns NULL on dedicated servers.
+ */
+UCLASS()
+class UShooterPickupManager : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/** returns the pickup manager of World, or NULL if pickups aren't animated there */
+	static UShooterPickupManager* Get(UWorld* World);
+
+	virtual void Deinitialize() override;
+
+	//Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	//End FTickableGameObject interface
+
+	/** takes over the mesh tick of Pickup and starts animating it around its current mesh transform */
+	void AddPickup(AShooterPickup* Pickup);
+
+	/** stops animating Pickup, puts its mesh back where it was and hands the mesh and effects ticks back to it */
+	void RemovePickup(AShooterPickup* Pickup);
+
+protected:
+
+	UPROPERTY(Transient)
+	TArray<FShooterIdlePickup> IdlePickups;
+};
@@ -5,6 +5,8 @@
 
 #include "ShooterTypes.h"
 #include "GameFramework/Character.h"
+#include "Weapons/ShooterHitValidation.h"
+#include "System/ShooterReplicationPolicy.h"
 #include "ShooterCharacter.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FBindableEvent_CharacterFired, AShooterWeapon*, Weapon, uint8, FireMode);
@@ -24,6 +26,10 @@ public:
 	virtual void Tick(float DeltaSeconds) override;
 	/** cleanup inventory */
 	virtual void Destroyed() override;
+	/** remove from the character spatial index */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	/** far away enemies get a lower priority while the viewer can't see them, see UShooterReplicationPolicy */
+	virtual float GetNetPriority(const FVector& ViewPos, const FVector& ViewDir, class AActor* Viewer, AActor* ViewTarget, class UActorChannel* InChannel, float Time, bool bLowBandwidth) override;
 	//End AActor interface
 
 	//Begin APawn interface
@@ -434,6 +440,15 @@ public:
 	UFUNCTION(BlueprintPure, Category=Health)
 	bool IsAlive() const;
 
+	/** changes each time this character is reused from UShooterMonsterPool, so anything remembered about a previous life can be told apart */
+	int32 GetLifeId() const { return LifeId; }
+
+	/** [server] location at world time Time, from the recent position history (current location if there's no history for it) */
+	FVector GetHistoricLocation(float Time) const { return PositionHistory.GetLocationAt(Time, GetActorLocation()); }
+
+	/** true while the last hit taken is still being replicated */
+	bool WasRecentlyHit() const { return GetWorld()->GetTimeSeconds() < LastTakeHitTimeTimeout; }
+
 	/** get current armor */
 	UFUNCTION(BlueprintPure, Category = Health)
 	float GetArmor() const;
@@ -448,6 +463,9 @@ public:
 
 	float GetMaxArmor() const;
 
+	/** [server] sets health and walk speed for this life, e.g. from FInvasionMonster; values <= 0 keep the class defaults */
+	void ApplySpawnOverrides(float NewHealth, float NewMaxWalkSpeed);
+
 	/** Adds shield, limited to MaxShield */
 	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = Health)
 	void GiveShield(float Amount);
@@ -499,6 +517,70 @@ protected:
 
 	FTimerHandle UpdatePlayerColorsAllMIDsHandle;
 
+	/** proximity index this character is registered in while alive */
+	UPROPERTY(Transient)
+	class UShooterCharacterSpatialIndex* SpatialIndex;
+
+	/** [server] recent locations, used to verify client side hits against where the shooter saw this character */
+	FShooterPositionHistory PositionHistory;
+
+	/** [server] replication policy of the world, NULL in standalone games */
+	UPROPERTY(Transient)
+	class UShooterReplicationPolicy* ReplicationPolicy;
+
+	/** [server] idle state and line of sight cache for the replication policy */
+	FShooterNetActivity NetActivity;
+
+	/** seconds between gameplay timer updates of server side bots */
+	UPROPERTY(EditDefaultsOnly, Category=Pawn)
+	float BotUpdateInterval;
+
+	/** seconds between gameplay timer updates of other players' characters that are seen up close, or controlled by a remote player on the server */
+	UPROPERTY(EditDefaultsOnly, Category=Pawn)
+	float NearUpdateInterval;
+
+	/** seconds between gameplay timer updates of other players' characters that are far away or not seen */
+	UPROPERTY(EditDefaultsOnly, Category=Pawn)
+	float FarUpdateInterval;
+
+	/** characters seen farther than this from the local camera use FarUpdateInterval */
+	UPROPERTY(EditDefaultsOnly, Category=Pawn)
+	float FarUpdateDistance;
+
+	/** time since the last UpdateGameplayTimers */
+	float PendingGameplayTime;
+
+	/** world time the current spell cooldown ends */
+	float SpellCooldownEndTime;
+
+	/** returns how often UpdateGameplayTimers runs for this character right now; 0 means every frame */
+	float GetGameplayUpdateInterval() const;
+
+	/** updates spell cooldown, shield and spell charge decay, health regen and the low health sound for the last DeltaSeconds */
+	void UpdateGameplayTimers(float DeltaSeconds);
+
+	/** runs UpdateGameplayTimers for PendingGameplayTime; called before shield or spell charge gains, so the time before a gain decays at the old state */
+	void FlushGameplayTimers();
+
+#if !UE_BUILD_SHIPPING
+	/** Mesh1P of the class defaults, looked up on first use */
+	USkeletalMeshComponent* DefaultMesh1P;
+#endif
+
+	friend class UShooterMonsterPool;
+
+	/** true while this monster is hidden, waiting in UShooterMonsterPool */
+	bool bInPool;
+
+	/** incremented on every ActivateFromPool */
+	int32 LifeId;
+
+	/** [pool] hides the character and stops movement, collision, ticking and timers; its inventory is destroyed without being dropped */
+	void DeactivateForPool();
+
+	/** [pool] restores full health and shows the character again at Location */
+	void ActivateFromPool(const FVector& Location, const FRotator& Rotation);
+
 	/** spawns a Weapon pickup upon character death */
 	void DropWeapon();
 
@@ -522,8 +604,27 @@ protected:
 	TArray<TSubclassOf<class AShooterWeapon> > StartingWeapons;
 
 	/** weapons in inventory */
-	UPROPERTY(Transient, Replicated)
+	UPROPERTY(Transient, ReplicatedUsing=OnRep_Inventory)
 	TArray<class AShooterItem*> Inventory;
+
+	/** [client] inventory changed, lookup index must be rebuilt */
+	UFUNCTION()
+	void OnRep_Inventory();
+
+	/** Inventory index of the first item of each class, including parent classes down to AShooterItem. Used by FindItem and FindWeapon. */
+	mutable TMap<UClass*, int32> InventoryIndexByClass;
+
+	/** Inventory index of the AShooterItem_Ammo that serves each weapon class */
+	mutable TMap<UClass*, int32> AmmoIndexByWeaponClass;
+
+	/** set when Inventory changes; the index is rebuilt on the next lookup */
+	mutable bool bInventoryIndexDirty;
+
+	/** rebuilds InventoryIndexByClass and AmmoIndexByWeaponClass if Inventory changed */
+	void UpdateInventoryIndex() const;
+
+	/** returns the ammo item for WeaponClass, if in inventory */
+	class AShooterItem_Ammo* FindAmmo(TSubclassOf<class AShooterWeapon> WeaponClass) const;
 	
 	/** meant to be used for a character class (e.g. monsters), rather than a cheat */
 	UPROPERTY(EditDefaultsOnly, Category = Inventory)
@@ -821,9 +922,11 @@ protected:
 	/** play effects on hit */
 	virtual void PlayHit(float DamageTaken, struct FDamageEvent const& DamageEvent, class APawn* PawnInstigator, class AActor* DamageCauser);
 
-	/** switch to ragdoll */
+	/** switch to ragdoll, if UShooterCorpseManager has room for it */
 	void SetRagdollPhysics();
 
+	friend class UShooterCorpseManager;
+
 	FTimerHandle SetRagdollPhysicsHandle;
 
 	/** sets up the replication for taking a hit */
@@ -0,0 +1,80 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Templates/Function.h"
+#include "ShooterCharacterSpatialIndex.generated.h"
+
+class AShooterCharacter;
+
+/** characters whose location falls in a single grid cell */
+USTRUCT()
+struct FShooterCharacterGridCell
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(Transient)
+	TArray<AShooterCharacter*> Characters;
+};
+
+/**
+ *	Uniform 2D grid (XY) of living AShooterCharacters, used for proximity queries instead of iterating every character in the world.
+ *	Characters register themselves in BeginPlay, update their cell in Tick and unregister when they die or leave play.
+ *	Exists on server and clients; each machine indexes the characters it knows about.
+ */
+UCLASS()
+class UShooterCharacterSpatialIndex : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	/** adds Character to the grid, at its current location */
+	void AddCharacter(AShooterCharacter* Character);
+
+	/** removes Character from the grid. Safe to call if it was never added. */
+	void RemoveCharacter(AShooterCharacter* Character);
+
+	/** moves Character to the cell of its current location, if it changed */
+	void UpdateCharacter(AShooterCharacter* Character);
+
+	/** adds to OutCharacters every living character within Radius of Center */
+	void GetCharactersInRadius(const FVector& Center, float Radius, TArray<AShooterCharacter*>& OutCharacters) const;
+
+	/** returns any living character within Radius of Center for which Predicate returns true, or NULL */
+	AShooterCharacter* FindCharacterInRadius(const FVector& Center, float Radius, TFunctionRef<bool(AShooterCharacter*)> Predicate) const;
+
+	/** 
+	 * Returns the living character closest to Center for which Predicate returns true, or NULL.
+	 * Predicate is called in order of increasing distance, and not called at all for characters farther than the result,
+	 * so it may be expensive (e.g. a line of sight check).
+	 */
+	AShooterCharacter* FindClosestCharacter(const FVector& Center, TFunctionRef<bool(AShooterCharacter*)> Predicate) const;
+
+	/** returns true if a capsule with HalfHeight and Radius placed at Point would overlap any living character other than IgnoreCharacter */
+	bool AnyCharacterOverlapsCapsule(const FVector& Point, float HalfHeight, float Radius, const AShooterCharacter* IgnoreCharacter = NULL) const;
+
+	/** size of each grid cell, in world units */
+	static const float CellSize;
+
+protected:
+
+	FIntPoint GetCellFor(const FVector& Location) const;
+
+	/** true if Character should be returned by queries */
+	static bool IsValidCandidate(const AShooterCharacter* Character);
+
+	/** occupied cells. Empty cells are removed. */
+	UPROPERTY(Transient)
+	TMap<FIntPoint, FShooterCharacterGridCell> Cells;
+
+	/** cell each registered character is currently in */
+	UPROPERTY(Transient)
+	TMap<AShooterCharacter*, FIntPoint> CharacterCells;
+
+	/** largest scaled capsule radius of all characters ever added; used to widen overlap queries */
+	float MaxCapsuleRadius;
+};
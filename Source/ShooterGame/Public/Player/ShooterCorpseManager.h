@@ -0,0 +1,125 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#pragma once
+
+#include "ShooterTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ShooterCorpseManager.generated.h"
+
+class AShooterCharacter;
+
+/** dead character still in the world */
+struct FShooterCorpse
+{
+	TWeakObjectPtr<AShooterCharacter> Character;
+
+	float DeathTime;
+
+	/** world time the ragdoll started simulating */
+	float RagdollStartTime;
+
+	/** ragdoll physics are running */
+	bool bSimulating;
+
+	/** [server] the dead character's inventory was destroyed */
+	bool bInventoryDestroyed;
+
+	FShooterCorpse()
+		: DeathTime(0.f)
+		, RagdollStartTime(0.f)
+		, bSimulating(false)
+		, bInventoryDestroyed(false)
+	{
+	}
+};
+
+/**
+ *	Keeps the cost of dead characters bounded.
+ *	Settled ragdolls are frozen in their current pose. Over MaxSimulatingCorpses, the oldest ragdolls are frozen as soon as they're slower than OverBudgetSettledSpeed,
+ *	so the budget can be exceeded for a while (at most MaxSimulationTime) when all ragdolls are still in flight.
+ *	When there are more than MaxCorpses, the oldest are removed. Also destroys the inventory of dead characters shortly after death.
+ *	Dedicated servers use their own, tighter limits, as nobody sees their ragdolls.
+ */
+UCLASS(config=Game)
+class UShooterCorpseManager : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UShooterCorpseManager();
+
+	/** returns the corpse manager of World, or NULL if it isn't a game world */
+	static UShooterCorpseManager* Get(UWorld* World);
+
+	//Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	//End FTickableGameObject interface
+
+	/** starts tracking a character that just died */
+	void AddCorpse(AShooterCharacter* Character);
+
+	/** true if Character may switch to ragdoll physics */
+	bool CanSimulateRagdoll() const;
+
+	/** notifies that Character's ragdoll started simulating */
+	void OnRagdollStarted(AShooterCharacter* Character);
+
+	/** max ragdolls simulating at once */
+	UPROPERTY(config)
+	int32 MaxSimulatingCorpses;
+
+	/** max corpses in the world */
+	UPROPERTY(config)
+	int32 MaxCorpses;
+
+	/** MaxSimulatingCorpses on dedicated servers */
+	UPROPERTY(config)
+	int32 DedicatedServerMaxSimulatingCorpses;
+
+	/** MaxCorpses on dedicated servers */
+	UPROPERTY(config)
+	int32 DedicatedServerMaxCorpses;
+
+	/** ragdolls simulate at least this long before they can be frozen as settled */
+	UPROPERTY(config)
+	float MinSimulationTime;
+
+	/** ragdolls are frozen after simulating this long, even if they haven't settled */
+	UPROPERTY(config)
+	float MaxSimulationTime;
+
+	/** ragdolls slower than this are considered settled */
+	UPROPERTY(config)
+	float SettledSpeed;
+
+	/** when over MaxSimulatingCorpses, the oldest ragdolls slower than this are frozen before they've settled */
+	UPROPERTY(config)
+	float OverBudgetSettledSpeed;
+
+	/** seconds after death the inventory of a dead character is destroyed */
+	UPROPERTY(config)
+	float DestroyInventoryDelay;
+
+protected:
+
+	/** stops Corpse's ragdoll simulation, keeping its current pose */
+	void FreezeCorpse(FShooterCorpse& Corpse);
+
+	/** true if Corpse's ragdoll is asleep or its root body is slower than Speed */
+	bool IsRagdollSlowerThan(const FShooterCorpse& Corpse, float Speed) const;
+
+	/** freezes the oldest slow ragdolls until at most MaxSimulating are left */
+	void EnforceSimulationBudget(int32 MaxSimulating, float Now);
+
+	int32 GetMaxSimulatingCorpses() const;
+
+	int32 GetMaxCorpses() const;
+
+	/** tracked corpses, oldest first */
+	TArray<FShooterCorpse> Corpses;
+};
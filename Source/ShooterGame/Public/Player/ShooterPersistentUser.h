@@ -4,10 +4,16 @@
 #pragma once
 
 #include "GameFramework/SaveGame.h"
+#include "Async/Future.h"
 #include "ShooterTypes.h"
 #include "GameRules/ShooterGameMode_Invasion.h"
 #include "ShooterPersistentUser.generated.h"
 
+class UShooterPersistentUser;
+
+DECLARE_DELEGATE_OneParam(FOnPersistentUserLoaded, UShooterPersistentUser*);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnPersistentUserSaved, bool);
+
 UCLASS(BlueprintType)
 class UShooterPersistentUser : public USaveGame
 {
@@ -19,6 +25,9 @@ public:
 	/** Loads user persistence data if it exists, creates an empty record otherwise. */
 	static UShooterPersistentUser* LoadPersistentUser2(FString SlotName, const int32 UserIndex);
 
+	/** Same as LoadPersistentUser2, but reads the slot on a worker thread. Callback runs on the game thread (with NULL if SlotName is empty). */
+	static void LoadPersistentUserAsync(FString SlotName, const int32 UserIndex, FOnPersistentUserLoaded Callback);
+
 	/** Saves data if anything has changed. */
 	UFUNCTION(BlueprintCallable, Category=SaveGame)
 	void SaveIfDirty();
@@ -26,6 +35,18 @@ public:
 	/** Records the result of a match. */
 	void AddMatchResult(int32 MatchKills, int32 MatchDeaths, int32 MatchSuicides, bool bIsMatchWinner);
 
+	/** true while a save is being written to disk */
+	bool IsSaveInProgress() const { return bSaveInProgress; }
+
+	/** Blocks until the save in flight has been written, then writes a queued save right away. Called before this user is dropped or the game exits. */
+	void FlushPendingSave();
+
+	/** FlushPendingSave on every persistent user with a save in flight */
+	static void FlushAllPendingSaves();
+
+	/** Broadcast on the game thread after each save finished writing, with whether it succeeded. */
+	FOnPersistentUserSaved OnSaveCompleted;
+
 	/** needed because we can recreate the subsystem that stores it */
 	void TellInputAboutKeybindings();
 
@@ -100,9 +121,18 @@ public:
 protected:
 	void SetToDefaults();
 
-	/** Triggers a save of this data. */
+	/**
+	 * Triggers a save of this data. The data is serialized right away and written on a worker thread; saves requested while one is in flight are coalesced
+	 * into a single follow-up save. The user is kept alive until the follow-up save is done, so dropping it right after saving doesn't lose data.
+	 */
 	void SavePersistentUser();
 
+	/** flushes any other persistent user writing to SlotName, so reads and writes of a slot never overlap */
+	static void FlushPendingSavesToSlot(const FString& SlotName, int32 UserIndex, const UShooterPersistentUser* Except = NULL);
+
+	/** called when the async write started by SavePersistentUser is done */
+	void OnSavePersistentUserFinished(bool bSuccess);
+
 	/** Lifetime count of kills */
 	UPROPERTY()
 	int32 Kills;
@@ -140,6 +170,15 @@ private:
 	/** Internal.  True if data is changed but hasn't been saved. */
 	bool bIsDirty;
 
+	/** Internal.  True while an async save is writing to disk. */
+	bool bSaveInProgress;
+
+	/** Internal.  True if another save was requested while one was in progress. */
+	bool bSaveQueued;
+
+	/** Internal.  The write started by SavePersistentUser; true if it succeeded. */
+	TFuture<bool> PendingSave;
+
 	/** The string identifier used to save/load this persistent user. */
 	FString SlotName;
 	int32 UserIndex;
@@ -73,6 +73,10 @@ public:
 	UFUNCTION(Reliable, Client)
 	void ClientSendMessage(EMessageTypes::Type MessageType, bool bRelativeToMe, const FString& InstigatorName = FString(), const FString& InstigatedName = FString(), uint8 OptionalRank = 0, uint8 OptionalTeam = 0);
 
+	/** Sends all the messages of a frame at once, see AShooterGameMode::MessagePlayers */
+	UFUNCTION(Reliable, Client)
+	void ClientSendMessages(const TArray<FShooterSentMessage>& Messages);
+
 	/** used for input simulation from blueprint (for automatic perf tests) */
 	UFUNCTION(BlueprintCallable, Category="Input")
 	void SimulateInputKey(FKey Key, bool bPressed = true);
@@ -370,6 +374,10 @@ protected:
 	UFUNCTION(exec)
 	virtual void SetSoundClassVolume(FString ClassName, float NewVolume);
 
+	/** while spectating, only cycles through characters of TeamNum (-1 for everyone), see AShooterSpectatorPawn::SpectateTeam */
+	UFUNCTION(exec)
+	void SpectateTeam(int32 TeamNum);
+
 	/** Notifies the server that the client has suicided */
 	UFUNCTION(Reliable, server, WithValidation)
 	void ServerSuicide();
@@ -17,6 +17,7 @@ public:
 
 	// Begin APlayerState interface
 	virtual void Reset() override; //also clear scores
+	virtual void OnRep_Score() override;
 	virtual void ClientInitialize(class AController* InController) override;
 	virtual void UnregisterPlayerWithSession() override;
 	// End APlayerState interface
@@ -87,8 +88,12 @@ public:
 	UFUNCTION(BlueprintCallable, Category=PlayerState)
 	void SetQuitter(bool bInQuitter);
 
+	/** also re-ranks the player state that was copied to */
 	virtual void CopyProperties(class APlayerState* PlayerState) override;
 
+	/** re-ranks this player after taking over PlayerState's properties */
+	virtual void OverrideWith(class APlayerState* PlayerState) override;
+
 	UFUNCTION(BlueprintPure, Category = PlayerState)
 	inline bool HasLivesRemaining() const { return LivesRemaining != 0; }
 
@@ -120,8 +125,14 @@ protected:
 	void OnRep_LivesRemaining();
 
 	/** team number */
-	UPROPERTY(Transient, Replicated)
+	UPROPERTY(Transient, ReplicatedUsing=OnRep_TeamNumber)
 	int32 TeamNumber;
+
+	UFUNCTION()
+	void OnRep_TeamNumber();
+
+	/** tells the game state to re-rank this player, after score or team changes */
+	void UpdateRank();
 	
 	/** color assigned to vector parameter Color1/2/3/etc on all character's meshes */
 	UPROPERTY(Transient, ReplicatedUsing=OnRep_PlayerColors)
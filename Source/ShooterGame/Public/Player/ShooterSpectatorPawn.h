@@ -36,6 +36,14 @@ public:
 	/** if false, free camera will not be allowed. */
 	bool bAllowFreeCam;
 
+	/** if not INDEX_NONE, next/previous only cycle through characters of this team */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category=Spectator)
+	int32 SpectatedTeamNum;
+
+	/** only cycles through characters of TeamNum from now on (INDEX_NONE for everyone), moving the focus to one of them if needed */
+	UFUNCTION(BlueprintCallable, Category=Spectator)
+	void SpectateTeam(int32 TeamNum);
+
 protected:
 	class USpringArmComponent* CameraBoom;
 	class UCameraComponent* Camera;
@@ -53,10 +61,10 @@ protected:
 	/** current view target */
 	class AActor* CurrentTarget;
 
-	/** returns the first alive ShooterCharacter found in the world's pawn iterator */
+	/** returns the first alive ShooterCharacter in the game state's spectator cycle */
 	class AShooterCharacter* GetFirstCharacter() const;
 	
-	/** returns the last alive ShooterCharacter found in the world's pawn iterator */
+	/** returns the last alive ShooterCharacter in the game state's spectator cycle */
 	class AShooterCharacter* GetLastCharacter() const;
 
 	float DesiredCameraDistance;
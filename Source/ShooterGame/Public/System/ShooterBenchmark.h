@@ -0,0 +1,97 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ShooterBenchmark.generated.h"
+
+/**
+ *	Bot load benchmark, only created when the game runs with -ShooterBenchmark. Meant for a headless dedicated server, e.g.:
+ *
+ *		ShooterGameServer DM-Deck?game=TDM?Bots=32 -ShooterBenchmark -nullrhi -nosound -ini:Engine:[OnlineSubsystem]:DefaultPlatformService=Null
+ *
+ *	The game mode creates the bots from the Bots option as usual (CreateBotControllers/StartBots); the benchmark starts the match
+ *	if it's still waiting, runs the engine with a fixed time step and seeded random streams, and after the measured ticks writes
+ *	a JSON report and exits.
+ *
+ *	Options: -BenchmarkTicks=3000 -BenchmarkWarmupTicks=300 -BenchmarkFPS=30 -BenchmarkSeed=0 -BenchmarkReport=<path>
+ *	(the report defaults to Saved/Benchmarks/<Map>_<Bots>bots.json)
+ */
+UCLASS()
+class UShooterBenchmark : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UShooterBenchmark();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	//Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	//End FTickableGameObject interface
+
+protected:
+
+	/** timing of a single measured frame, in milliseconds */
+	struct FFrameSample
+	{
+		/** from the previous frame's sample to this one */
+		double FrameTime;
+
+		/** actor and component ticks of the world (AI, movement, weapons, etc.) */
+		double ActorTick;
+
+		/** timers and tickable objects after the actor ticks (game mode timers, world subsystems) */
+		double PostActorTick;
+
+		/** everything outside the world tick (networking, garbage collection, end of frame) */
+		double Other;
+	};
+
+	void OnWorldTickStart(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+	void OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+
+	/** writes the JSON report to ReportPath */
+	void WriteReport() const;
+
+	/** ticks to run before measuring, so bot spawning and level streaming don't skew the numbers */
+	int32 WarmupTicks;
+
+	/** measured ticks */
+	int32 MeasuredTicks;
+
+	/** seed for the global random streams */
+	int32 Seed;
+
+	/** fixed frame rate the engine runs at */
+	float FixedFPS;
+
+	FString ReportPath;
+
+	/** ticks seen so far, including warmup */
+	int32 TickCount;
+
+	/** set once the report has been written */
+	bool bFinished;
+
+	/** FPlatformTime::Seconds() at the last sample points of the current frame */
+	double LastFrameEnd;
+	double WorldTickStart;
+	double PostActorTickStart;
+
+	/** bot count when measuring started */
+	int32 NumBots;
+
+	TArray<FFrameSample> Samples;
+
+	FDelegateHandle OnWorldTickStartHandle;
+	FDelegateHandle OnWorldPostActorTickHandle;
+};
@@ -0,0 +1,73 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#pragma once
+
+#include "ShooterTypes.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "ShooterMapCatalog.generated.h"
+
+/** streaming level that is only loaded when a game has at least NumTeams teams (e.g. DM-MyMap_3teams) */
+USTRUCT()
+struct FShooterTeamStreamingLevel
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	FName LevelName;
+
+	UPROPERTY()
+	uint8 NumTeams;
+
+	FShooterTeamStreamingLevel()
+		: NumTeams(0)
+	{
+	}
+};
+
+/** team streaming levels of a single base map */
+USTRUCT()
+struct FShooterTeamStreamingLevels
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	TArray<FShooterTeamStreamingLevel> Levels;
+};
+
+/**
+ *	Index of the maps in Content/Maps, built once when the engine starts instead of walking the directory every time it's needed.
+ *	Holds the FMapInfo of every base map (read from the metadata AShooterWorldSettings writes) and the _Nteams streaming levels of each of them.
+ */
+UCLASS()
+class UShooterMapCatalog : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** returns the catalog, or NULL if the engine isn't up yet */
+	static UShooterMapCatalog* Get();
+
+	/** scans Content/Maps again; only needed when maps or their metadata change while running (e.g. saving a map in the editor) */
+	void Rebuild();
+
+	/** info of all base maps (maps without an underscore in their name) */
+	const TArray<FMapInfo>& GetMaps() const { return Maps; }
+
+	/** adds the base maps that support arena game modes to OutMaps */
+	void GetArenaMaps(TArray<FMapInfo>& OutMaps) const;
+
+	/** adds the streaming levels of MapName needed for a game with NumTeams teams to OutLevels, sorted by team count */
+	void GetTeamStreamingLevels(const FString& MapName, uint8 NumTeams, TArray<FName>& OutLevels) const;
+
+protected:
+
+	UPROPERTY()
+	TArray<FMapInfo> Maps;
+
+	/** base map name -> its _Nteams streaming levels */
+	UPROPERTY()
+	TMap<FString, FShooterTeamStreamingLevels> TeamStreamingLevels;
+};
@@ -0,0 +1,171 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#pragma once
+
+#include "ShooterTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterReplicationPolicy.generated.h"
+
+class AShooterCharacter;
+
+/** replication rates of a group of actors */
+USTRUCT()
+struct FShooterNetTier
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** updates per second while the actor is active */
+	UPROPERTY()
+	float NetUpdateFrequency;
+
+	/** updates per second while the actor is idle */
+	UPROPERTY()
+	float MinNetUpdateFrequency;
+
+	UPROPERTY()
+	float NetPriority;
+
+	/** not relevant to viewers further away than this; 0 keeps the actor's own cull distance */
+	UPROPERTY()
+	float NetCullDistance;
+
+	FShooterNetTier()
+		: NetUpdateFrequency(10.f)
+		, MinNetUpdateFrequency(2.f)
+		, NetPriority(1.f)
+		, NetCullDistance(0.f)
+	{
+	}
+
+	FShooterNetTier(float InNetUpdateFrequency, float InMinNetUpdateFrequency, float InNetPriority, float InNetCullDistance)
+		: NetUpdateFrequency(InNetUpdateFrequency)
+		, MinNetUpdateFrequency(InMinNetUpdateFrequency)
+		, NetPriority(InNetPriority)
+		, NetCullDistance(InNetCullDistance)
+	{
+	}
+};
+
+/** when a character was last seen by one viewer, see UShooterReplicationPolicy::GetOccludedPriorityScale */
+struct FShooterNetVisibility
+{
+	TWeakObjectPtr<const AActor> Viewer;
+
+	/** world time of the next line of sight test */
+	float NextCheckTime;
+
+	/** world time the character was last visible to Viewer */
+	float LastVisibleTime;
+
+	FShooterNetVisibility()
+		: NextCheckTime(0.f)
+		, LastVisibleTime(-BIG_NUMBER)
+	{
+	}
+};
+
+/** replication state of a single character, see UShooterReplicationPolicy::UpdateCharacterRate */
+struct FShooterNetActivity
+{
+	/** world time the character last moved, aimed, fired or got hit */
+	float LastActiveTime;
+
+	/** aim at the last update, to tell a character looking around from an idle one */
+	FRotator LastAimRotation;
+
+	bool bActive;
+
+	/** per viewer line of sight results */
+	TArray<FShooterNetVisibility> Visibility;
+
+	FShooterNetActivity()
+		: LastActiveTime(0.f)
+		, LastAimRotation(ForceInit)
+		, bActive(true)
+	{
+	}
+};
+
+/**
+ *	Server side replication settings of characters, weapons, inventory items, pickups and projectiles, read from the [/Script/ShooterGame.ShooterReplicationPolicy] section of Game.ini.
+ *	Characters switch between the active and idle rate of their tier depending on what they're doing, and far away enemies get a lower priority while a viewer can't see them.
+ *	Get() returns NULL on clients and in standalone games.
+ */
+UCLASS(config=Game)
+class UShooterReplicationPolicy : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	UShooterReplicationPolicy();
+
+	virtual void Deinitialize() override;
+
+	/** returns the policy of World, or NULL if World doesn't replicate actors */
+	static UShooterReplicationPolicy* Get(UWorld* World);
+
+	/** sets Actor's update rate, priority and cull distance to Tier's (active rate) */
+	static void ApplyTier(AActor* Actor, const FShooterNetTier& Tier);
+
+	/** switches Character and its weapon between the active and idle rates */
+	void UpdateCharacterRate(AShooterCharacter* Character, FShooterNetActivity& Activity) const;
+
+	/**
+	 * Returns OccludedPriorityScale if Character is an enemy far from Viewer's view point and hidden from it, 1 otherwise; results are cached in Activity for VisibilityCheckInterval.
+	 * Hidden characters stay relevant, so their channel isn't closed (which would destroy and respawn them and their inventory on the client).
+	 */
+	float GetOccludedPriorityScale(const AShooterCharacter* Character, FShooterNetActivity& Activity, const AActor* Viewer, const AActor* ViewTarget, const FVector& ViewPos) const;
+
+	/** captures Duration seconds of replication, then logs the replicated actors, channels and update rates of each class. With the network profiler compiled in, bytes per class are written to a .nprof file as well. */
+	void StartNetReport(float Duration);
+
+	UPROPERTY(config)
+	FShooterNetTier CharacterTier;
+
+	/** weapon in the hands of a character */
+	UPROPERTY(config)
+	FShooterNetTier EquippedWeaponTier;
+
+	/** items and weapons carried but not used */
+	UPROPERTY(config)
+	FShooterNetTier InventoryTier;
+
+	UPROPERTY(config)
+	FShooterNetTier PickupTier;
+
+	/** replicated projectiles (bReplicateProjectiles or AShooterProjectile::bAlwaysReplicate) */
+	UPROPERTY(config)
+	FShooterNetTier ProjectileTier;
+
+	/** characters not moving, aiming, firing or getting hit for this long use the idle rate */
+	UPROPERTY(config)
+	float IdleDelay;
+
+	/** NetPriority of active characters is scaled by this */
+	UPROPERTY(config)
+	float ActivePriorityScale;
+
+	/** enemies further than this from a viewer get a lower priority while out of its line of sight; 0 disables the visibility test */
+	UPROPERTY(config)
+	float OccludedDistance;
+
+	/** NetPriority of far away enemies a viewer can't see is scaled by this */
+	UPROPERTY(config)
+	float OccludedPriorityScale;
+
+	/** seconds between line of sight tests of a character and a viewer */
+	UPROPERTY(config)
+	float VisibilityCheckInterval;
+
+	/** a character keeps its full priority for this long after it was last seen, so it's up to date when it comes around a corner again */
+	UPROPERTY(config)
+	float VisibilityHoldTime;
+
+protected:
+
+	/** logs the report and stops the capture */
+	void FinishNetReport();
+
+	FTimerHandle NetReportHandle;
+};
@@ -42,6 +42,39 @@ struct FGameMessage
 	FText RemoteMessageText;	
 };
 
+/** a message sent to a player, see AShooterPlayerController::ClientSendMessage for the meaning of the fields */
+USTRUCT()
+struct FShooterSentMessage
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	TEnumAsByte<EMessageTypes::Type> MessageType;
+
+	UPROPERTY()
+	bool bRelativeToMe;
+
+	UPROPERTY()
+	FString InstigatorName;
+
+	UPROPERTY()
+	FString InstigatedName;
+
+	UPROPERTY()
+	uint8 OptionalRank;
+
+	UPROPERTY()
+	uint8 OptionalTeam;
+
+	FShooterSentMessage()
+		: MessageType(EMessageTypes::FirstBlood)
+		, bRelativeToMe(false)
+		, OptionalRank(0)
+		, OptionalTeam(0)
+	{
+	}
+};
+
 /**
  * Class that handles gameplay and announcer messages (e.g. Red Flag Taken, Double Kill, Headshot, etc).
  * Instanced and used by the Game Mode.
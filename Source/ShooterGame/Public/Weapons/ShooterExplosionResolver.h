@@ -0,0 +1,58 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ShooterExplosionResolver.generated.h"
+
+/** radial damage waiting to be applied */
+struct FShooterPendingExplosion
+{
+	FVector Origin;
+	float BaseDamage;
+	float Radius;
+	TSubclassOf<UDamageType> DamageType;
+	TWeakObjectPtr<AActor> DamageCauser;
+	TWeakObjectPtr<AController> InstigatedBy;
+};
+
+/**
+ *	Applies the radial damage of every explosion of a frame at once, instead of an UGameplayStatics::ApplyRadialDamage per explosion.
+ *	Nearby explosions share a single overlap query, and each overlapped component is then tested against every explosion's own sphere.
+ *	Damage works as with ApplyRadialDamage: every damageable actor other than the damage causer that overlaps the radius and is in sight
+ *	of the origin takes damage with a FRadialDamageEvent, with linear falloff. Unlike ApplyRadialDamage, it's dealt at the end of the frame.
+ */
+UCLASS()
+class UShooterExplosionResolver : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/** returns the explosion resolver of World, or NULL if there is none and damage must be applied directly */
+	static UShooterExplosionResolver* Get(UWorld* World);
+
+	virtual void Deinitialize() override;
+
+	//Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	//End FTickableGameObject interface
+
+	/** queues radial damage around Origin, applied at the end of this frame's tick */
+	void QueueExplosion(const FVector& Origin, float BaseDamage, float Radius, TSubclassOf<UDamageType> DamageType, AActor* DamageCauser, AController* InstigatedBy);
+
+protected:
+
+	/** a cluster's shared query sphere is never bigger than this times the radius of its biggest explosion */
+	static const float MaxClusterScale;
+
+	/** explosions queued this frame */
+	TArray<FShooterPendingExplosion> PendingExplosions;
+
+	/** true if nothing blocks ECC_Visibility from Origin to VictimComp; OutHit is where it's hit. Same test as ApplyRadialDamage. */
+	static bool IsDamageableFrom(UPrimitiveComponent* VictimComp, const FVector& Origin, const FCollisionQueryParams& TraceParams, FHitResult& OutHit);
+};
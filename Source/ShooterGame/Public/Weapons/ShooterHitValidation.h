@@ -0,0 +1,105 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ *	Recent locations of a character, recorded by the server so client side hits (bClientSideHitVerification)
+ *	can be checked against where the shooter saw the target instead of where it is now.
+ *	Fixed size ring buffer, so recording and lookups have a bounded cost.
+ */
+struct FShooterPositionHistory
+{
+	/** number of samples kept; with SampleInterval this covers MaxSamples * SampleInterval seconds */
+	static const int32 MaxSamples = 16;
+
+	/** min time between samples, in seconds */
+	static const float SampleInterval;
+
+	FShooterPositionHistory();
+
+	/** adds a sample if at least SampleInterval passed since the last one */
+	void Record(float Time, const FVector& Location);
+
+	/** returns the location at Time, interpolated between samples. Times older than the history return the oldest sample, newer ones CurrentLocation. */
+	FVector GetLocationAt(float Time, const FVector& CurrentLocation) const;
+
+	void Reset();
+
+private:
+
+	float Times[MaxSamples];
+	FVector Locations[MaxSamples];
+
+	/** index of the newest sample */
+	int32 Newest;
+
+	int32 NumSamples;
+};
+
+/**
+ *	Server side bookkeeping of the shots a remote client reported with ServerNotifyShot/ServerNotifyInstantHit.
+ *	Enforces the weapon's fire rate with a burst allowance for network jitter, and remembers the last few
+ *	accepted shots so hits can only be claimed for a shot that was fired, and only as many as it has pellets and bounces.
+ *	Shots are identified by a sequence number the client increments for every shot it reports.
+ */
+struct FShooterShotValidator
+{
+	/** number of accepted shots hits can be claimed for */
+	static const int32 MaxRecentShots = 8;
+
+	/** shots that can always be fired back to back after a pause, to absorb packets arriving in clumps */
+	static const float MinBurstShots;
+
+	/** longest clump of shot packets allowed for, in seconds */
+	static const float MaxJitterWindow;
+
+	/** how long after a shot hits can still be claimed for it, in seconds */
+	static const float MaxShotAge;
+
+	FShooterShotValidator();
+
+	/** returns the accepted shot with this client sequence number and fire mode, or INDEX_NONE */
+	int32 FindShot(float Now, uint16 Sequence, uint8 FireMode) const;
+
+	/** random seed the shot at ShotIndex (returned by FindShot/AddShot) was accepted with */
+	uint8 GetShotSeed(int32 ShotIndex) const { return RecentShots[ShotIndex].Seed; }
+
+	/** shots that may be fired back to back after a pause: as many as fit into JitterWindow (usually the shooter's ping), at least MinBurstShots */
+	static float GetMaxBurstShots(float TimeBetweenShots, float JitterWindow);
+
+	/** returns false if the shot comes faster than TimeBetweenShots allows, after up to MaxBurstShots back to back shots; otherwise uses up one shot of fire rate */
+	bool ConsumeFireCadence(float Now, float TimeBetweenShots, float MaxBurstShots);
+
+	/** remembers an accepted shot that may deal up to MaxHits hits; returns its index */
+	int32 AddShot(float Now, uint16 Sequence, uint8 Seed, uint8 FireMode, int32 MaxHits);
+
+	/** uses up one hit of the shot at ShotIndex (returned by FindShot/AddShot); false if it has none left */
+	bool ConsumeHit(int32 ShotIndex);
+
+	void Reset();
+
+private:
+
+	struct FShot
+	{
+		float Time;
+		int32 HitsLeft;
+		/** shots are told apart by the client's sequence number; seeds repeat too often with automatic weapons */
+		uint16 Sequence;
+		uint8 Seed;
+		uint8 FireMode;
+	};
+
+	FShot RecentShots[MaxRecentShots];
+
+	/** slot the next shot is written to */
+	int32 NextShot;
+
+	/** shots that may currently be fired without breaking the fire rate */
+	float ShotCredits;
+
+	/** time ShotCredits was last updated */
+	float LastCreditTime;
+};
@@ -23,6 +23,7 @@ public:
 	/** setup velocity */
 	void InitVelocity(FVector& ShootDirection);
 
+	/** sets owner, instigator, seed and velocity of a shot; used for both freshly spawned and pooled projectiles */
 	void InitProjectile(APawn* InInstigator, uint8& InRandomSeed, class AShooterWeapon* InOwnerWeapon, FVector& ShootDirection);
 
 	/** handle hit */
@@ -52,6 +53,14 @@ public:
 	UFUNCTION(BlueprintImplementableEvent, Category = Projectile)
 	void ProjectileExploded(const FHitResult& HitResult);
 
+	/** [everyone] called when the projectile starts flying, on BeginPlay and again each time it's reused from the pool. Start fuses and the like here instead of in BeginPlay. */
+	UFUNCTION(BlueprintImplementableEvent, Category = Projectile)
+	void ProjectileActivated();
+
+	/** [everyone] called when the projectile is put back into the pool; its latent actions (delays) have been cancelled already */
+	UFUNCTION(BlueprintImplementableEvent, Category = Projectile)
+	void ProjectileReset();
+
 	/** Call to explode this projectile. */
 	UFUNCTION(BlueprintCallable, Category=Projectile)
 	void ExplodeProjectile();
@@ -83,6 +92,23 @@ public:
 	UPROPERTY(BlueprintReadOnly, Replicated, Category=Projectile)
 	class AShooterWeapon* OwnerWeapon;
 
+	/** how many projectiles of this class each weapon using it spawns in advance (non-replicated projectiles only) */
+	UPROPERTY(EditDefaultsOnly, Category=Pooling)
+	int32 PoolPrewarmCount;
+
+	/** time after exploding until this projectile is returned to the pool; gives the trail particles time to fade out */
+	UPROPERTY(EditDefaultsOnly, Category=Pooling)
+	float PoolReturnDelay;
+
+	/** whether this projectile can be recycled by UShooterProjectilePool (true if it's not replicated and its class can be pooled) */
+	bool CanBePooled() const;
+
+	/** false for blueprints that implement BeginPlay or Tick, since BeginPlay only runs once and their state would carry over to the next shot */
+	static bool CanClassBePooled(UClass* ProjectileClass);
+
+	/** fires ProjectileActivated, unless the projectile is being spawned for the pool */
+	virtual void BeginPlay() override;
+
 protected:
 	
 	/** life time */
@@ -139,6 +165,26 @@ protected:
 
 	FTimerHandle StopIgnoringInstigatorHandle;
 
+	//////////////////////////////////////////////////////////////////////////
+	// Pooling
+
+	friend class UShooterProjectilePool;
+
+	/** true while this projectile is inactive, waiting in UShooterProjectilePool */
+	bool bInPool;
+
+	/** expires or recycles a pooled projectile; replaces LifeSpan for projectiles that can be pooled */
+	FTimerHandle ReturnToPoolHandle;
+
+	/** gives this projectile back to UShooterProjectilePool */
+	void ReturnToPool();
+
+	/** [pool] hides the projectile and stops movement, collision, particles, sound and timers */
+	void DeactivateForPool();
+
+	/** [pool] resets the projectile to its class defaults and starts it again at SpawnTM; InitProjectile sets up the shot and fires ProjectileActivated */
+	void ActivateFromPool(const FTransform& SpawnTM);
+
 	/** reference to the level's DirectionalLight */
 	class ADirectionalLight* Sun;
 };
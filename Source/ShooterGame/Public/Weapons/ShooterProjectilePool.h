@@ -0,0 +1,59 @@
+// Copyright 2013-2014 Rampaging Blue Whale Games. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterProjectilePool.generated.h"
+
+class AShooterProjectile;
+
+/** inactive projectiles of a single class */
+USTRUCT()
+struct FShooterProjectilePoolEntry
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** projectiles waiting to be reused */
+	UPROPERTY(Transient)
+	TArray<AShooterProjectile*> FreeProjectiles;
+
+	/** false if projectiles of this class replicate, in which case they are never pooled */
+	bool bPoolable;
+
+	FShooterProjectilePoolEntry()
+		: bPoolable(true)
+	{
+	}
+};
+
+/**
+ *	Keeps exploded and expired projectiles around so that AShooterWeapon::FireProjectile can reuse them instead of spawning new actors.
+ *	Exists on server and clients, since non-replicated projectiles are spawned locally on every machine.
+ *	Replicated projectiles (bReplicateProjectiles or AShooterProjectile::bAlwaysReplicate) are not pooled.
+ */
+UCLASS()
+class UShooterProjectilePool : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	/** spawns up to Count inactive projectiles of ProjectileClass, so the first shots don't need to spawn actors */
+	void PrewarmProjectiles(TSubclassOf<AShooterProjectile> ProjectileClass, int32 Count);
+
+	/** returns an inactive projectile of ProjectileClass moved to SpawnTM, or NULL if there is none. Call InitProjectile on it afterwards. */
+	AShooterProjectile* AcquireProjectile(TSubclassOf<AShooterProjectile> ProjectileClass, const FTransform& SpawnTM);
+
+	/** deactivates Projectile and keeps it for reuse; destroys it instead if the pool for its class is full */
+	void ReleaseProjectile(AShooterProjectile* Projectile);
+
+	/** max inactive projectiles kept per class */
+	static const int32 MaxPooledPerClass = 32;
+
+protected:
+
+	UPROPERTY(Transient)
+	TMap<UClass*, FShooterProjectilePoolEntry> Pools;
+};
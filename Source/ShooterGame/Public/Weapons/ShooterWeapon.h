@@ -5,6 +5,7 @@
 
 #include "ShooterDamageType.h"
 #include "Items/ShooterItem.h"
+#include "Weapons/ShooterHitValidation.h"
 #include "ShooterWeapon.generated.h"
 
 #define NUM_FIRING_MODES 2
@@ -296,6 +297,19 @@ struct FInstantWeaponData
 	UPROPERTY(EditDefaultsOnly, Category=HitVerification)
 	float AllowedViewDotHitDir;
 
+	/** beam mode: min time between traces of the beam FX, in seconds. The beam is interpolated between traces. 0 traces every tick. */
+	UPROPERTY(EditDefaultsOnly, Category=Beam)
+	float BeamTraceInterval;
+
+	/** beam mode: the beam FX isn't traced again while the muzzle moved less than this (in cm) and the aim turned less than BeamTraceMinAngle,
+	 *	unless the beam is touching something that can move */
+	UPROPERTY(EditDefaultsOnly, Category=Beam)
+	float BeamTraceMinMove;
+
+	/** beam mode: see BeamTraceMinMove, in degrees */
+	UPROPERTY(EditDefaultsOnly, Category=Beam)
+	float BeamTraceMinAngle;
+
 	/** defaults */
 	FInstantWeaponData()
 	{
@@ -309,6 +323,74 @@ struct FInstantWeaponData
 		HeadshotDamageMultiplier = 1.3f;
 		AllowedViewDotHitDir = 0.8f;
 		BulletsToSpawn = 1;
+		BeamTraceInterval = 0.05f;
+		BeamTraceMinMove = 1.f;
+		BeamTraceMinAngle = 0.25f;
+	}
+};
+
+/** a single pellet of an instant hit shot. All pellets of a fire event are swept together one bounce at a time, so the sweeps of a bounce can run in parallel.
+ *	The same entry is reused for each bounce of the pellet. */
+struct FInstantHitTrace
+{
+	/** trace start for the current bounce */
+	FVector StartTrace;
+
+	/** trace end for the current bounce */
+	FVector EndTrace;
+
+	/** shot direction for the current bounce */
+	FVector ShootDir;
+
+	/** result of the last trace */
+	FHitResult Impact;
+
+	/** index of this pellet within the fire event (ShotIndex * BulletsToSpawn + Pellet), sent to the server on ServerNotifyInstantHit */
+	uint8 PelletIndex;
+
+	/** current bounce number */
+	uint8 Bounce;
+
+	/** whether this pellet still needs to be traced (false after it stops bouncing) */
+	bool bActive;
+
+	FInstantHitTrace()
+		: StartTrace(ForceInitToZero)
+		, EndTrace(ForceInitToZero)
+		, ShootDir(ForceInitToZero)
+		, Impact(ForceInit)
+		, PelletIndex(0)
+		, Bounce(0)
+		, bActive(true)
+	{
+	}
+};
+
+/** one bounce of one shot of a beam, as drawn by its BeamPSC */
+struct FBeamSegment
+{
+	/** endpoints drawn when the last trace was made; the beam moves from these to Start/End until the next trace */
+	FVector FromStart;
+	FVector FromEnd;
+
+	/** endpoints found by the last trace */
+	FVector Start;
+	FVector End;
+
+	/** false if the beam didn't bounce this far in the last trace */
+	bool bVisible;
+
+	/** bVisible of the trace before, if false the segment appears at Start/End without interpolating */
+	bool bWasVisible;
+
+	FBeamSegment()
+		: FromStart(ForceInitToZero)
+		, FromEnd(ForceInitToZero)
+		, Start(ForceInitToZero)
+		, End(ForceInitToZero)
+		, bVisible(false)
+		, bWasVisible(false)
+	{
 	}
 };
 
@@ -887,6 +969,9 @@ protected:
 	
 	uint8 PreviousSeed;
 
+	/** [client] sequence number of the last shot reported with ServerNotifyShot, tells shots with the same seed apart */
+	uint16 ClientShotSequence;
+
 	/** burst counter, used for replicating fire events to remote clients */
 	UPROPERTY(Transient, ReplicatedUsing=OnRep_BurstCounter)
 	uint8 BurstCounter;
@@ -896,11 +981,11 @@ protected:
 
 	/** server notified of instant hit from client to verify and deal damage */
 	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerNotifyInstantHit(FHitResult Impact, uint8 RandomSeed, uint8 ShotIndex, uint8 BounceNumber);
+	void ServerNotifyInstantHit(FHitResult Impact, uint8 RandomSeed, uint16 ShotSequence, uint8 ShotIndex, uint8 BounceNumber);
 
 	/** server notified of instant hit shot to show trail FX on server and other clients */
 	UFUNCTION(Server, Unreliable, WithValidation)
-	void ServerNotifyShot(uint8 RandomSeed);
+	void ServerNotifyShot(uint8 RandomSeed, uint16 ShotSequence);
 	
 	UFUNCTION()
 	void OnRep_HitNotify();
@@ -963,12 +1048,59 @@ protected:
 	UFUNCTION(BlueprintCallable, Category=Weapon)
 	TArray<FHitResult> WeaponTraceMulti(FVector TraceFrom = FVector::ZeroVector, FVector TraceTo = FVector::ZeroVector, AActor* IgnoreActor = NULL, float TraceDist = 100000.0f) const;
 
+	/** [local + server] builds the traces for every shot and pellet of a fire event.
+	 *	@param bRequireAmmo Whether this is an actual shot, which consumes ammo for each shot and stops when the weapon runs out of it (false for simulated FX) */
+	void BuildInstantHitTraces(TArray<FInstantHitTrace>& OutTraces, uint8 RandomSeed, bool bRequireAmmo);
+
+	/** runs the sweep for every active entry of Traces, sharing the query setup among all of them; larger batches are swept in parallel on task graph workers */
+	void ResolveInstantHitTraces(TArray<FInstantHitTrace>& Traces) const;
+
+	/** reflects Trace off its last impact for the next bounce, or deactivates it if it should not bounce anymore */
+	void AdvanceInstantHitBounce(FInstantHitTrace& Trace, bool bNotifyBounce = true);
+
+	/** pellets of the fire event being processed; kept as a member to reuse its allocation */
+	TArray<FInstantHitTrace> InstantHitTraces;
+
+	/** direction of pellet PelletIndex of the fire event with RandomSeed, in aim space (rotate by the aim to get the shot direction).
+	 *	Each pellet has its own stream, so the server can rebuild any pellet of a client side shot without replaying the ones before it. */
+	static FVector GetPelletDirection(uint8 RandomSeed, int32 PelletIndex, float ConeHalfAngle);
+
+	/** [server] fire rate and ammo bookkeeping of shots reported by a client when bClientSideHitVerification is on */
+	FShooterShotValidator ShotValidator;
+
+	/** [server] accepts a shot reported by the client: checks the fire rate, consumes ammo and replicates its FX.
+	 *	Returns the shot's index in ShotValidator (also for shots that were already accepted), or INDEX_NONE if it was rejected. */
+	int32 ServerAcceptShot(uint8 RandomSeed, uint16 ShotSequence, bool& bOutNewShot);
+
 	/** update Beam trail FX */
 	void UpdateBeam();
 
 	/** Beam particle component, for each bounce */
 	TArray<UParticleSystemComponent*> BeamPSC;
 
+	/** traced endpoints for each entry of BeamPSC */
+	TArray<FBeamSegment> BeamSegments;
+
+	/** world time, muzzle location and aim direction of the last beam trace */
+	float LastBeamTraceTime;
+	FVector LastBeamTraceOrigin;
+	FVector LastBeamTraceAimDir;
+
+	/** whether the last beam trace touched an actor that can move, in which case skipping traces would leave the beam behind */
+	bool bBeamHitMovable;
+
+	/** interpolation alpha last applied to BeamPSC */
+	float LastBeamAlpha;
+
+	/** traces the beam FX for every shot and bounce */
+	void TraceBeam(const FVector& AimDir, const FVector& Origin);
+
+	/** starts a new beam trace aimed at AimDir from Origin: the currently drawn beam becomes the start of the interpolation, and all segments are hidden until set again */
+	void BeginBeamTrace(const FVector& AimDir, const FVector& Origin);
+
+	/** stores the segments of the pellets in Traces that are drawn as beams (the first pellet of each shot) */
+	void SetBeamSegments(const TArray<FInstantHitTrace>& Traces);
+
 	//////////////////////////////////////////////////////////////////////////
 	// Weapon usage helpers
 